@@ -0,0 +1,22 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+// host stand-in for the parts of the core the host tests compile against
+
+#ifndef WIFI_MGR_BENCH_ARDUINO_H
+#define WIFI_MGR_BENCH_ARDUINO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class IPAddress {
+public:
+    IPAddress() : IPAddress(0, 0, 0, 0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+    uint8_t operator[](int index) const { return bytes[index]; }
+
+private:
+    uint8_t bytes[4];
+};
+
+#endif //WIFI_MGR_BENCH_ARDUINO_H
@@ -0,0 +1,30 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+// host stand-in for the core's EEPROM class, only what wifi_mgr_eeprom.cpp uses
+
+#ifndef WIFI_MGR_BENCH_EEPROM_H
+#define WIFI_MGR_BENCH_EEPROM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class EEPROMClass {
+public:
+    void begin(size_t size) { (void) size; }
+    uint8_t read(int address) { return data[address]; }
+    void write(int address, uint8_t value) { data[address] = value; }
+    bool commit() { return true; }
+    bool end() { return true; }
+    uint8_t* getDataPtr() { return data; }
+    const uint8_t* getConstDataPtr() const { return data; }
+    size_t length() { return sizeof(data); }
+    void erase() { memset(data, 0xFF, sizeof(data)); }
+
+private:
+    uint8_t data[8192];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif //WIFI_MGR_BENCH_EEPROM_H
@@ -0,0 +1,53 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+// host stand-in for the core's UDP socket: packets are queued by the test and responses are collected
+
+#ifndef WIFI_MGR_BENCH_WIFI_UDP_H
+#define WIFI_MGR_BENCH_WIFI_UDP_H
+
+#include <deque>
+#include <vector>
+#include "Arduino.h"
+
+class WiFiUDP {
+public:
+    std::deque<std::vector<uint8_t>> incoming;
+    std::vector<std::vector<uint8_t>> sent;
+
+    uint8_t begin(uint16_t port) {
+        (void) port;
+        return 1;
+    }
+    void stop() {}
+    int parsePacket() {
+        if (current.empty() && !incoming.empty()) {
+            current = incoming.front();
+            incoming.pop_front();
+        }
+        return current.size();
+    }
+    int read(uint8_t* buffer, size_t size) {
+        size_t len = current.size() < size ? current.size() : size;
+        memcpy(buffer, current.data(), len);
+        current.clear();
+        return len;
+    }
+    IPAddress remoteIP() { return IPAddress(192, 168, 4, 2); }
+    uint16_t remotePort() { return 5353; }
+    int beginPacket(IPAddress ip, uint16_t port) {
+        (void) ip;
+        (void) port;
+        sent.emplace_back();
+        return 1;
+    }
+    size_t write(const uint8_t* buffer, size_t size) {
+        sent.back().insert(sent.back().end(), buffer, buffer + size);
+        return size;
+    }
+    int endPacket() { return 1; }
+
+private:
+    std::vector<uint8_t> current;
+};
+
+#endif //WIFI_MGR_BENCH_WIFI_UDP_H
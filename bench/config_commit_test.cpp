@@ -0,0 +1,70 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+// Host regression test of the differential commit against the image layout. Build and run from the repository root:
+// g++ -std=gnu++17 -g -fsanitize=address,undefined -DESP8266 -Ibench -Iinclude
+//     bench/config_commit_test.cpp src/wifi_mgr_eeprom.cpp -o config_commit_test && ./config_commit_test
+
+#include <cstdio>
+#include <cstring>
+#include "wifi_mgr_eeprom.h"
+
+EEPROMClass EEPROM;
+
+int testFailures = 0;
+
+void expectConfig(const char* step, const char* name, const char* expected) {
+    const char* value = wifiMgrGetConfig(name);
+    if (value == expected || (value != nullptr && expected != nullptr && strcmp(value, expected) == 0)) return;
+    printf("%s: %s is \"%s\", expected \"%s\"\n", step, name, value != nullptr ? value : "(null)", expected != nullptr ? expected : "(null)");
+    testFailures++;
+}
+
+// an empty value stays a record of the image, a commit behind it must not land on the entries before it
+void testEmptyValueBeforeChange() {
+    EEPROM.erase();
+    wifiMgrClearEEPROM();
+    wifiMgrSetConfig("A", "a");
+    wifiMgrSetConfig("BB", "bb");
+    wifiMgrSetConfig("CCC", "ccc");
+    wifiMgrCommitEEPROM();
+    wifiMgrSetConfig("A", "");
+    wifiMgrCommitEEPROM();
+
+    wifiMgrClearEEPROM();
+    expectConfig("reload", "A", "");
+    wifiMgrSetConfig("CCC", "changed");
+    wifiMgrCommitEEPROM();
+    expectConfig("commit", "BB", "bb");
+    expectConfig("commit", "CCC", "changed");
+
+    wifiMgrClearEEPROM();
+    expectConfig("second reload", "A", "");
+    expectConfig("second reload", "BB", "bb");
+    expectConfig("second reload", "CCC", "changed");
+}
+
+// an image with a nameless record, the cache cannot hold it, so the next commit rewrites everything
+void testNamelessRecord() {
+    EEPROM.erase();
+    const uint8_t image[] = {0x43, 0x96, 0x00, 0x02, 3,
+                             0, 0, 1, 'x', 0,
+                             1, 'A', 0, 1, 'a', 0,
+                             2, 'B', 'B', 0, 2, 'b', 'b', 0};
+    for (size_t i = 0; i < sizeof(image); i++) EEPROM.write(i, image[i]);
+    wifiMgrClearEEPROM();
+    expectConfig("nameless", "BB", "bb");
+    wifiMgrSetConfig("BB", "changed");
+    wifiMgrCommitEEPROM();
+
+    wifiMgrClearEEPROM();
+    expectConfig("nameless reload", "A", "a");
+    expectConfig("nameless reload", "BB", "changed");
+}
+
+int main() {
+    wifiMgrConfigureEEPROM(0, 1024);
+    testEmptyValueBeforeChange();
+    testNamelessRecord();
+    printf("%s\n", testFailures == 0 ? "ok" : "FAILED");
+    return testFailures == 0 ? 0 : 1;
+}
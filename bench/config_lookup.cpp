@@ -0,0 +1,62 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+// Host microbenchmark of config lookups with 8, 32 and 128 keys. Build and run from the repository root:
+// g++ -std=gnu++17 -O2 -DESP8266 -DWIFI_MGR_MAX_CONFIG_ENTRIES=128 -DWIFI_MGR_CONFIG_INDEX_SIZE=256 -Ibench -Iinclude
+//     bench/config_lookup.cpp src/wifi_mgr_eeprom.cpp -o config_lookup && ./config_lookup
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "wifi_mgr_eeprom.h"
+
+EEPROMClass EEPROM;
+
+#define BENCH_LOOKUPS 2000000
+#define BENCH_MAX_KEYS 128
+
+char benchNames[BENCH_MAX_KEYS][16];
+uint32_t benchHashes[BENCH_MAX_KEYS];
+
+// the strcmp scan over all slots the index replaced, as a baseline
+const char* benchLinearLookup(const char* name, int keys) {
+    for (int i = 0; i < keys; i++) {
+        if (strcmp(benchNames[i], name) == 0) return benchNames[i];
+    }
+    return nullptr;
+}
+
+template <typename Lookup> double benchRun(int keys, Lookup lookup) {
+    volatile uintptr_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        // a fixed stride, so the keys are not read in insertion order
+        sink = sink + (uintptr_t) lookup((i * 7) % keys);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / BENCH_LOOKUPS;
+}
+
+int main() {
+    const int keyCounts[] = {8, 32, 128};
+    wifiMgrConfigureEEPROM(0, 8192);
+    printf("keys  linear ns  hashed ns  precomputed ns\n");
+    for (int keys : keyCounts) {
+        EEPROM.erase();
+        wifiMgrClearEEPROM();
+        for (int i = 0; i < keys; i++) {
+            // a shared prefix, like MQTT_HOST / MQTT_PORT, makes strcmp work for it
+            snprintf(benchNames[i], sizeof(benchNames[i]), "CONFIG_KEY_%d", i);
+            benchHashes[i] = wifiMgrConfigHash(benchNames[i]);
+            if (!wifiMgrSetConfig(benchNames[i], "value")) {
+                printf("could not store %d keys\n", keys);
+                return 1;
+            }
+        }
+        wifiMgrCommitEEPROM();
+        double linear = benchRun(keys, [keys](int i) { return benchLinearLookup(benchNames[i], keys); });
+        double hashed = benchRun(keys, [](int i) { return wifiMgrGetConfig(benchNames[i]); });
+        double precomputed = benchRun(keys, [](int i) { return wifiMgrGetConfig(benchNames[i], benchHashes[i]); });
+        printf("%4d  %9.1f  %9.1f  %14.1f\n", keys, linear, hashed, precomputed);
+    }
+    return 0;
+}
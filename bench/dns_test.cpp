@@ -0,0 +1,119 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+// Host test of the captive portal DNS responder. Build and run from the repository root:
+// g++ -std=gnu++17 -g -fsanitize=address,undefined -Ibench -Iinclude bench/dns_test.cpp src/wifi_mgr_dns.cpp
+//     -o dns_test && ./dns_test
+
+#include <cstdio>
+#include <vector>
+#include "wifi_mgr_dns.h"
+#include <WiFiUdp.h>
+
+extern WiFiUDP wifiMgrDnsUdp;
+
+const uint8_t testIP[4] = {192, 168, 4, 1};
+int testFailures = 0;
+
+void expect(bool condition, const char* what) {
+    if (condition) return;
+    printf("failed: %s\n", what);
+    testFailures++;
+}
+
+// header with one question for name (dotted, labels are built here), then type and class IN
+std::vector<uint8_t> testQuery(const char* name, uint16_t type) {
+    std::vector<uint8_t> packet = {0x12, 0x34, 0x01, 0x00, 0, 1, 0, 0, 0, 0, 0, 0};
+    while (*name != 0) {
+        const char* dot = strchr(name, '.');
+        size_t len = dot != nullptr ? dot - name : strlen(name);
+        packet.push_back(len);
+        packet.insert(packet.end(), name, name + len);
+        name += len + (dot != nullptr ? 1 : 0);
+    }
+    packet.push_back(0);
+    packet.insert(packet.end(), {(uint8_t) (type >> 8), (uint8_t) type, 0, 1});
+    return packet;
+}
+
+size_t testAnswer(std::vector<uint8_t>& packet) {
+    size_t len = packet.size();
+    packet.resize(WIFI_MGR_DNS_BUFFER_SIZE);
+    return wifiMgrDnsAnswer(packet.data(), len, packet.size(), testIP);
+}
+
+uint16_t testRead16(const std::vector<uint8_t>& packet, size_t pos) {
+    return (packet[pos] << 8) | packet[pos + 1];
+}
+
+void testA() {
+    std::vector<uint8_t> packet = testQuery("connectivitycheck.gstatic.com", 1);
+    size_t questionEnd = packet.size();
+    size_t len = testAnswer(packet);
+    expect(len == questionEnd + 16, "A: answer appended to the question");
+    expect(testRead16(packet, 0) == 0x1234, "A: id kept");
+    expect((packet[2] & 0x80) && (packet[3] & 0x0F) == 0, "A: NOERROR response");
+    expect(testRead16(packet, 6) == 1, "A: one answer");
+    expect(testRead16(packet, questionEnd) == 0xC00C, "A: answer name points to the question");
+    expect(testRead16(packet, questionEnd + 2) == 1 && testRead16(packet, questionEnd + 10) == 4, "A: type A with 4 bytes of data");
+    expect(memcmp(packet.data() + questionEnd + 12, testIP, 4) == 0, "A: softAP address");
+}
+
+void testAAAA() {
+    std::vector<uint8_t> packet = testQuery("captive.apple.com", 28);
+    size_t questionEnd = packet.size();
+    size_t len = testAnswer(packet);
+    expect(len == questionEnd, "AAAA: question only");
+    expect((packet[3] & 0x0F) == 0 && testRead16(packet, 6) == 0, "AAAA: empty NOERROR answer");
+}
+
+void testEdns() {
+    std::vector<uint8_t> packet = testQuery("example.com", 1);
+    size_t questionEnd = packet.size();
+    packet[11] = 1; // ARCOUNT
+    // OPT: root name, type 41, 4096 byte payload, no extended flags or options
+    packet.insert(packet.end(), {0, 0, 41, 0x10, 0x00, 0, 0, 0, 0, 0, 0});
+    size_t len = testAnswer(packet);
+    expect(len == questionEnd + 16, "EDNS: OPT record dropped, answer behind the question");
+    expect(testRead16(packet, 6) == 1 && testRead16(packet, 10) == 0, "EDNS: one answer, no additional records");
+    expect(memcmp(packet.data() + questionEnd + 12, testIP, 4) == 0, "EDNS: softAP address");
+}
+
+void testTruncatedName() {
+    std::vector<uint8_t> packet = testQuery("example.com", 1);
+    // cut inside the second label
+    packet.resize(12 + 10);
+    size_t len = testAnswer(packet);
+    expect(len == 12, "truncated name: header only");
+    expect((packet[2] & 0x80) && (packet[3] & 0x0F) == 1, "truncated name: FORMERR");
+    expect(testRead16(packet, 4) == 0 && testRead16(packet, 6) == 0, "truncated name: no question or answer");
+}
+
+void testCompressionPointer() {
+    std::vector<uint8_t> packet = {0x12, 0x34, 0x01, 0x00, 0, 1, 0, 0, 0, 0, 0, 0, 0xC0, 0x0C, 0, 1, 0, 1};
+    size_t len = testAnswer(packet);
+    expect(len == 12 && (packet[3] & 0x0F) == 1, "compression pointer in the question: FORMERR");
+}
+
+// the whole loop through the UDP stand-in, a response is never answered
+void testLoop() {
+    wifiMgrDnsStart(IPAddress(192, 168, 4, 1));
+    wifiMgrDnsUdp.incoming.push_back(testQuery("example.com", 1));
+    std::vector<uint8_t> response = testQuery("example.com", 1);
+    response[2] |= 0x80;
+    wifiMgrDnsUdp.incoming.push_back(response);
+    wifiMgrDnsLoop();
+    expect(wifiMgrDnsUdp.sent.size() == 1, "loop: one response sent");
+    expect(!wifiMgrDnsUdp.sent.empty() && testRead16(wifiMgrDnsUdp.sent[0], 6) == 1, "loop: the response carries the answer");
+    wifiMgrDnsStop();
+}
+
+int main() {
+    testA();
+    testAAAA();
+    testEdns();
+    testTruncatedName();
+    testCompressionPointer();
+    testLoop();
+    printf("%s\n", testFailures == 0 ? "ok" : "FAILED");
+    return testFailures == 0 ? 0 : 1;
+}
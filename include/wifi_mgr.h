@@ -29,10 +29,28 @@
 #error "This hardware is not supported"
 #endif
 
+enum WifiMgrConnectPhase {
+    WIFI_MGR_IDLE = 0,
+    WIFI_MGR_DISCONNECTING = 1,
+    WIFI_MGR_SCANNING = 2,
+    WIFI_MGR_SELECTING = 3,
+    WIFI_MGR_ASSOCIATING = 4,
+    WIFI_MGR_DHCP = 5,
+    WIFI_MGR_CONNECTED = 6
+};
+
+enum WifiMgrScanPolicy {
+    WIFI_MGR_SCAN_ALL = 0, // every network on every channel
+    WIFI_MGR_SCAN_SSID = 1, // directed probe for the configured SSID on every channel
+    WIFI_MGR_SCAN_LEARNED_CHANNELS = 2 // directed probe on the channels the SSID was seen on before, all channels as fallback
+};
+
 void setupWifi(const char* SSID, const char* password);
 void setupWifi(const char* SSID, const char* password, const char* hostname);
+void setupWifi(const char* SSID, const char* password, const char* hostname, IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns);
 void setupWifi(const char* SSID, const char* password, const char* hostname, unsigned long tolerateBadRSSms, unsigned long waitForConnectMs);
 void setupWifi(const char* SSID, const char* password, const char* hostname, unsigned long tolerateBadRSSms, unsigned long waitForConnectMs, unsigned long wifiMgrWaitForScanMs, unsigned long rescanInterval);
+void setupWifi(const char* SSID, const char* password, const char* hostname, unsigned long tolerateBadRSSms, unsigned long waitForConnectMs, unsigned long wifiMgrWaitForScanMs, unsigned long rescanInterval, WifiMgrScanPolicy scanPolicy);
 void loopWifi();
 void wifiMgrExpose(XWebServer *server_);
 XWebServer* wifiMgrGetWebServer();
@@ -43,4 +61,53 @@ void setLoopFunction(void (*loopFunctionPointerArg)(void));
 void wifiMgrCleanup(); // Function to clean up resources before restart
 void setRescanInterval(unsigned long rescanInterval);
 
+// Non-blocking connection handling: wifiMgrConnect() only starts an attempt, loopWifi() advances it.
+// The step budget limits how long a single loopWifi() call may spend advancing phases.
+void wifiMgrConnect();
+// Like setupWifi() but returns right away, loopWifi() does the connecting
+void wifiMgrBeginWifi(const char* SSID, const char* password, const char* hostname);
+WifiMgrConnectPhase wifiMgrGetConnectPhase();
+const char* wifiMgrGetConnectPhaseName();
+// Keeps the softAP of the portal running while (re)connecting the station
+void wifiMgrSetKeepAP(bool keepAP);
+void wifiMgrSetConnectStepBudget(unsigned long budgetMs);
+// How scans look for the configured SSIDs, takes effect with the next scan
+void wifiMgrSetScanPolicy(WifiMgrScanPolicy scanPolicy);
+// Additional networks in priority order, tried after the one passed to setupWifi().
+// Candidates are ranked by RSSI, priority and the connection history of each BSSID.
+bool wifiMgrAddNetwork(const char* SSID, const char* password);
+void wifiMgrClearNetworks();
+void wifiMgrLoadNetworksFromConfig();
+// A static ip of 0.0.0.0 means DHCP. With reuse lease enabled the last DHCP lease is applied right away
+// on reconnects and renewed in the background once connected.
+void wifiMgrSetStaticIP(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns);
+void wifiMgrSetReuseLease(bool enabled);
+// Jittered exponential backoff between failed attempts and for blacklisting BSSIDs that failed to connect
+void wifiMgrSetBackoff(unsigned long retryBaseMs, unsigned long retryMaxMs, unsigned long blacklistBaseMs, unsigned long blacklistMaxMs);
+// When enabled (default) the periodic rescan keeps the current link and only re-associates
+// if another BSSID of the same SSID is at least hysteresisDb stronger.
+void wifiMgrSetRoaming(bool enabled, uint8_t hysteresisDb);
+// When enabled (default) the first attempt goes straight to the last successful BSSID/channel
+// and only falls back to a scan if that fails. The cache lives in RTC memory, persist also keeps it in the config store.
+void wifiMgrSetFastReconnect(bool enabled, bool persist);
+
+// Chunked responses: output is collected in a small fixed buffer that is sent as one chunk
+// of a CONTENT_LENGTH_UNKNOWN response whenever it fills up, so no page needs one large buffer.
+#ifndef WIFI_MGR_CHUNK_SIZE
+#define WIFI_MGR_CHUNK_SIZE 256
+#endif
+struct WifiMgrChunkWriter {
+    XWebServer* server;
+    char buffer[WIFI_MGR_CHUNK_SIZE];
+    size_t len;
+};
+void wifiMgrChunkBegin(WifiMgrChunkWriter* writer, XWebServer* server, int code, const char* contentType);
+void wifiMgrChunkWrite(WifiMgrChunkWriter* writer, const char* data, size_t len);
+void wifiMgrChunkWrite(WifiMgrChunkWriter* writer, const char* str);
+// a single formatted piece may be at most WIFI_MGR_CHUNK_SIZE - 1 long
+void wifiMgrChunkPrintf(WifiMgrChunkWriter* writer, const char* format, ...);
+void wifiMgrChunkEnd(WifiMgrChunkWriter* writer);
+// wraps a handler so its run time ends up in the HTTP latency histogram of /wifiMgr/metrics
+std::function<void(void)> wifiMgrTimed(void (*handler)(void));
+
 #endif //WIFI_MGR_H
@@ -0,0 +1,32 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#ifndef WIFI_MGR_DNS_H
+#define WIFI_MGR_DNS_H
+
+#if __has_include("my_config.h")
+#include "my_config.h"
+#endif
+
+#if __has_include("configuration.h")
+#include "configuration.h"
+#endif
+
+#include <Arduino.h>
+
+// largest DNS message handled, plain UDP DNS is limited to 512 bytes
+#define WIFI_MGR_DNS_BUFFER_SIZE 512
+#ifndef WIFI_MGR_DNS_TTL
+#define WIFI_MGR_DNS_TTL 10
+#endif
+
+// Wildcard DNS for the portal AP: every A query is answered with the softAP address,
+// so phones detect the captive portal and open it on their own.
+void wifiMgrDnsStart(IPAddress ip);
+void wifiMgrDnsLoop();
+void wifiMgrDnsStop();
+
+// Turns the query in packet (len bytes, buffer of size bytes) into the response in place.
+// Returns the length of the response or 0 if nothing should be sent. Does not touch the network.
+size_t wifiMgrDnsAnswer(uint8_t* packet, size_t len, size_t size, const uint8_t ip[4]);
+
+#endif //WIFI_MGR_DNS_H
@@ -13,18 +13,39 @@
 
 #include <EEPROM.h>
 
+// FNV-1a of a config name, for lookup indexes. constexpr, but the compiler is free to run it at runtime
+// unless the result is needed as a constant, see WIFI_MGR_CONFIG_KEY()
+constexpr uint32_t wifiMgrConfigHash(const char* name, uint32_t hash = 2166136261UL) {
+    return *name == 0 ? hash : wifiMgrConfigHash(name + 1, (hash ^ (uint8_t) *name) * 16777619UL);
+}
+template <uint32_t hash> struct WifiMgrConfigHashConstant {
+    static constexpr uint32_t value = hash;
+};
+// a literal name followed by its hash, computed at compile time: wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("HOST"))
+#define WIFI_MGR_CONFIG_KEY(name) name, WifiMgrConfigHashConstant<wifiMgrConfigHash(name)>::value
+
+// Values are served from the RAM mirror of EEPROM.begin(), so EEPROM.end() or a begin() with
+// another size must not be called afterwards without wifiMgrClearEEPROM() first.
 void wifiMgrConfigureEEPROM(int startAddress, int size);
 bool wifiMgrSetupEEPROM();
 bool wifiMgrCommitEEPROM();
 void wifiMgrClearEEPROM();
-const char* wifiMgrGetConfig(const char* name);
+// The returned value stays valid until a config value is set or wifiMgrClearEEPROM() is called, by the sketch or by
+// saving the portal form, copy it to keep it across those. The library's own fast reconnect record (WM_BSSID) has a
+// fixed width and is rewritten in place, it never moves other committed values.
+// The getters taking a hash skip hashing the name, e.g. for WIFI_MGR_CONFIG_KEY() or names stored with their hash
+const char* wifiMgrGetConfig(const char* name, uint32_t hash);
+inline const char* wifiMgrGetConfig(const char* name) { return wifiMgrGetConfig(name, wifiMgrConfigHash(name)); }
 bool wifiMgrSetConfig(const char* name, const char* value);
 bool wifiMgrSetConfig(const char* name, const char* value, uint8_t len);
-long wifiMgrGetLongConfig(const char* name, long def);
+long wifiMgrGetLongConfig(const char* name, uint32_t hash, long def);
+inline long wifiMgrGetLongConfig(const char* name, long def) { return wifiMgrGetLongConfig(name, wifiMgrConfigHash(name), def); }
 bool wifiMgrSetLongConfig(const char* name, long val);
-unsigned long wifiMgrGetUlongConfig(const char* name, unsigned long def);
+unsigned long wifiMgrGetUlongConfig(const char* name, uint32_t hash, unsigned long def);
+inline unsigned long wifiMgrGetUlongConfig(const char* name, unsigned long def) { return wifiMgrGetUlongConfig(name, wifiMgrConfigHash(name), def); }
 bool wifiMgrSetUlongConfig(const char* name, unsigned long val);
-bool wifiMgrGetBoolConfig(const char* name, bool def);
+bool wifiMgrGetBoolConfig(const char* name, uint32_t hash, bool def);
+inline bool wifiMgrGetBoolConfig(const char* name, bool def) { return wifiMgrGetBoolConfig(name, wifiMgrConfigHash(name), def); }
 bool wifiMgrSetBoolConfig(const char* name, bool val);
 
 #endif //WIFI_MGR_EEPROM_H
@@ -0,0 +1,33 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#ifndef WIFI_MGR_EVENTS_H
+#define WIFI_MGR_EVENTS_H
+
+#if __has_include("my_config.h")
+#include "my_config.h"
+#endif
+
+#if __has_include("configuration.h")
+#include "configuration.h"
+#endif
+
+#include <wifi_mgr.h>
+
+// open /wifiMgr/events connections, further subscribers get a 503
+#ifndef WIFI_MGR_EVENTS_MAX_CLIENTS
+#define WIFI_MGR_EVENTS_MAX_CLIENTS 4
+#endif
+// a heap event is sent whenever the lowest free heap seen dropped by this much
+#ifndef WIFI_MGR_EVENTS_HEAP_STEP
+#define WIFI_MGR_EVENTS_HEAP_STEP 1024
+#endif
+
+// Server-Sent Events: subscribers get a snapshot first and then only changes
+// (event: phase / bssid / rssi / heap, data is a small JSON object).
+// Writes never block, a client that cannot keep up is dropped.
+void wifiMgrEventsSubscribe(XWebServer* server);
+// checks for changes and pushes them, called by loopWifi()
+void wifiMgrEventsLoop();
+void wifiMgrEventsStop();
+
+#endif //WIFI_MGR_EVENTS_H
@@ -0,0 +1,43 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#ifndef WIFI_MGR_JOURNAL_H
+#define WIFI_MGR_JOURNAL_H
+
+#if __has_include("my_config.h")
+#include "my_config.h"
+#endif
+
+#if __has_include("configuration.h")
+#include "configuration.h"
+#endif
+
+#include <wifi_mgr.h>
+
+// Define WIFI_MGR_CONFIG_JOURNAL to keep the config in an append-only journal instead of the EEPROM
+// table. Every commit appends the changed entries as (name, value, seq) records, replay on boot keeps
+// the highest seq per name. When the last free sector is opened, the live records of the oldest
+// one are copied forward and it is erased later from loopWifi().
+// Location: WIFI_MGR_JOURNAL_FIRST_SECTOR (ESP8266, flash sector number, must not overlap the
+// sketch, OTA or filesystem area) or a data partition named WIFI_MGR_JOURNAL_PARTITION (ESP32).
+// The whole config has to fit into one sector.
+#ifndef WIFI_MGR_JOURNAL_SECTORS
+#define WIFI_MGR_JOURNAL_SECTORS 4
+#endif
+#ifndef WIFI_MGR_JOURNAL_PARTITION
+#define WIFI_MGR_JOURNAL_PARTITION "wifimgr"
+#endif
+
+// name and value are terminated, they are only valid during the call
+typedef void (*WifiMgrJournalRecordHandler)(const char* name, uint8_t nameLen, const char* value, uint8_t valueLen, uint32_t seq);
+// true if the record is still the newest one of its name
+typedef bool (*WifiMgrJournalLiveCheck)(const char* name, uint8_t nameLen, uint32_t seq);
+
+// finds the head sector and replays every record, isLive has to work once replay is done
+bool wifiMgrJournalBegin(WifiMgrJournalRecordHandler handler, WifiMgrJournalLiveCheck isLive);
+// appends a record and stores its seq, isLive decides what is copied when a sector is reclaimed
+bool wifiMgrJournalAppend(const char* name, uint8_t nameLen, const char* value, uint8_t valueLen, uint32_t* seq,
+                          WifiMgrJournalLiveCheck isLive);
+// erases a reclaimed sector, if any
+void wifiMgrJournalLoop();
+
+#endif //WIFI_MGR_JOURNAL_H
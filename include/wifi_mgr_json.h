@@ -0,0 +1,50 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#ifndef WIFI_MGR_JSON_H
+#define WIFI_MGR_JSON_H
+
+#if __has_include("my_config.h")
+#include "my_config.h"
+#endif
+
+#if __has_include("configuration.h")
+#include "configuration.h"
+#endif
+
+#include <wifi_mgr.h>
+
+// Minimal JSON support for the portal api: values are written straight into a chunked response
+// and requests are read member by member from the body, nothing is built up in memory.
+
+enum WifiMgrJsonType {
+    WIFI_MGR_JSON_STRING = 0,
+    WIFI_MGR_JSON_NUMBER = 1,
+    WIFI_MGR_JSON_BOOL = 2,
+    WIFI_MGR_JSON_NULL = 3
+};
+
+struct WifiMgrJsonParser {
+    const char* pos;
+    const char* end;
+    bool first;
+};
+
+struct WifiMgrJsonValue {
+    WifiMgrJsonType type;
+    // strings are decoded into the caller's buffer
+    char* string;
+    size_t stringSize;
+    size_t stringLen;
+    long number;
+    bool boolean;
+};
+
+// writes value as quoted and escaped JSON string, null for nullptr
+void wifiMgrJsonWriteString(WifiMgrChunkWriter* writer, const char* value);
+
+// only flat objects are supported: {"key": "string" | integer | true | false | null, ...}
+bool wifiMgrJsonBegin(WifiMgrJsonParser* parser, const char* json, size_t len);
+// returns 1 for a member, 0 at the end of the object and -1 for invalid or unsupported input
+int wifiMgrJsonNextMember(WifiMgrJsonParser* parser, char* key, size_t keySize, WifiMgrJsonValue* value);
+
+#endif //WIFI_MGR_JSON_H
@@ -18,15 +18,20 @@ struct PortalConfigEntry {
     bool isPassword;
     bool restartOnChange;
     PortalConfigEntry* next;
+    uint32_t keyHash; // wifiMgrConfigHash(eepromKey)
+    int16_t argIndex; // request argument holding this entry, only valid while a form is decoded
 };
 
 // Define the callback function type for on-change listeners
 typedef void (*WifiMgrPortalOnChangeCallback)(int numChanges);
 
+// When sharing the server from wifiMgrExpose(), collect the "If-None-Match" header for cached asset responses
 void wifiMgrPortalSetup(bool redirectIndex, const char* ssidPrefix, const char* password);
 bool wifiMgrPortalLoop();
 void wifiMgrPortalAddConfigEntry(const char* name, const char* eepromKey, PortalConfigEntryType type, bool isPassword, bool restartOnChange);
 void wifiMgrPortalCleanup(); // Add cleanup function declaration
+void wifiMgrPortalUseExtraNetworks(); // SSID_2 / WIFI_PW_2 ... for wifiMgrLoadNetworksFromConfig()
+void wifiMgrPortalUseStaticIPConfigs(); // WM_IP / WM_GW / WM_MASK / WM_DNS / WM_LEASE
 
 // On-change listener functions
 void wifiMgrPortalAddOnChangeListener(WifiMgrPortalOnChangeCallback callback);
@@ -0,0 +1,36 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#ifndef WIFI_MGR_SCAN_CACHE_H
+#define WIFI_MGR_SCAN_CACHE_H
+
+#if __has_include("my_config.h")
+#include "my_config.h"
+#endif
+
+#if __has_include("configuration.h")
+#include "configuration.h"
+#endif
+
+#include <wifi_mgr.h>
+
+// number of SSIDs kept, the weakest one is replaced when the table is full
+#ifndef WIFI_MGR_SCAN_CACHE_SIZE
+#define WIFI_MGR_SCAN_CACHE_SIZE 16
+#endif
+#ifndef WIFI_MGR_SCAN_CACHE_INTERVAL
+#define WIFI_MGR_SCAN_CACHE_INTERVAL 30000
+#endif
+// SSIDs not seen for this long are dropped
+#ifndef WIFI_MGR_SCAN_CACHE_MAX_AGE
+#define WIFI_MGR_SCAN_CACHE_MAX_AGE 120000
+#endif
+
+// Background scan for the portal SSID picker: one async scan per interval no matter how many
+// clients ask, results are deduplicated by SSID (strongest BSSID wins).
+void wifiMgrScanCacheLoop();
+// forgets a running scan, e.g. because the station is about to connect
+void wifiMgrScanCacheStop();
+// {"age":..,"scanning":..,"networks":[{"ssid":..,"rssi":..,"channel":..,"auth":..,"open":..,"age":..}]}, strongest first
+void wifiMgrScanCacheWriteJson(WifiMgrChunkWriter* writer);
+
+#endif //WIFI_MGR_SCAN_CACHE_H
@@ -0,0 +1,72 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#ifndef WIFI_MGR_STATS_H
+#define WIFI_MGR_STATS_H
+
+#if __has_include("my_config.h")
+#include "my_config.h"
+#endif
+
+#if __has_include("configuration.h")
+#include "configuration.h"
+#endif
+
+#include <Arduino.h>
+
+// number of RSSI samples kept for /wifiMgr/linkquality (one per second while connected)
+#ifndef WIFI_MGR_RSSI_SAMPLES
+#define WIFI_MGR_RSSI_SAMPLES 64
+#endif
+
+// number of connection attempts kept for /wifiMgr/trace
+#ifndef WIFI_MGR_TRACE_SIZE
+#define WIFI_MGR_TRACE_SIZE 8
+#endif
+
+#define WIFI_MGR_TRACE_FAST 0x01
+#define WIFI_MGR_TRACE_ROAM 0x02
+
+enum WifiMgrTraceResult {
+    WIFI_MGR_TRACE_RUNNING = 0,
+    WIFI_MGR_TRACE_CONNECTED = 1,
+    WIFI_MGR_TRACE_FAILED = 2,
+    WIFI_MGR_TRACE_KEPT = 3 // roaming scan found nothing better
+};
+
+// latency histograms exposed at /wifiMgr/metrics
+enum WifiMgrHistogramId {
+    WIFI_MGR_HISTOGRAM_SCAN = 0,
+    WIFI_MGR_HISTOGRAM_CONNECT = 1,
+    WIFI_MGR_HISTOGRAM_HTTP = 2,
+    WIFI_MGR_HISTOGRAM_COUNT = 3
+};
+
+// timeline of one connection attempt, all durations in ms
+struct WifiMgrConnectTrace {
+    unsigned long start;
+    uint16_t disconnectMs;
+    uint16_t scanMs;
+    uint16_t associateMs;
+    uint16_t dhcpMs;
+    uint16_t mdnsMs;
+    uint16_t serverMs;
+    uint8_t networks;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t flags;
+    uint8_t result;
+};
+
+void wifiMgrStatsAddRssi(int8_t rssi);
+void wifiMgrStatsResetSmoothing();
+int8_t wifiMgrStatsSmoothedRssi();
+size_t wifiMgrStatsFormatLinkQuality(char* buffer, size_t size);
+WifiMgrConnectTrace* wifiMgrTraceStart(uint8_t flags);
+// index 0 is the most recent attempt. returns 0 if there is no such attempt
+size_t wifiMgrTraceFormat(uint8_t index, char* buffer, size_t size);
+
+void wifiMgrStatsObserve(WifiMgrHistogramId histogram, uint32_t durationUs);
+// OpenMetrics text of one histogram, one line per call. returns 0 after the last line
+size_t wifiMgrStatsFormatHistogram(WifiMgrHistogramId histogram, uint8_t line, char* buffer, size_t size);
+
+#endif //WIFI_MGR_STATS_H
@@ -1,6 +1,26 @@
 // PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
 
 #include "wifi_mgr.h"
+#include "wifi_mgr_eeprom.h"
+#include "wifi_mgr_stats.h"
+#include "wifi_mgr_events.h"
+#if defined(WIFI_MGR_CONFIG_JOURNAL)
+#include "wifi_mgr_journal.h"
+#endif
+#include <atomic>
+
+#ifndef WIFI_MGR_MAX_NETWORKS
+#define WIFI_MGR_MAX_NETWORKS 4
+#endif
+#ifndef WIFI_MGR_MAX_BSSID_HISTORY
+#define WIFI_MGR_MAX_BSSID_HISTORY 8
+#endif
+
+// RTC user memory block (4 bytes each) used for the fast reconnect cache. The first blocks are used by OTA
+#ifndef WIFI_MGR_RTC_OFFSET
+#define WIFI_MGR_RTC_OFFSET 32
+#endif
+#define WIFI_MGR_FAST_CONNECT_MAGIC 0x57464332
 
 #if defined(ESP8266)
 MDNSResponder wifiMgrMdns;
@@ -27,11 +47,129 @@ unsigned long wifiMgrInvalidIPCount = 0;
 unsigned long wifiMgrPostStartedServerCount = 0;
 uint8_t wifiMgrRebootAfterUnsuccessfullTries = 0;
 uint8_t wifiMgrUnsuccessfullTries = 0;
+WifiMgrConnectPhase wifiMgrPhase = WIFI_MGR_IDLE;
+unsigned long wifiMgrPhaseSince = 0;
+unsigned long wifiMgrConnectStepBudgetMs = 5;
+WifiMgrConnectTrace* wifiMgrTrace = nullptr;
+unsigned long wifiMgrRoamCount = 0;
+bool wifiMgrRoaming = true;
+bool wifiMgrRoamScan = false;
+uint8_t wifiMgrRoamHysteresis = 8; // dB
+unsigned long wifiMgrFastConnectCount = 0;
+unsigned long wifiMgrBootConnectMs = 0;
+bool wifiMgrBootFastPath = false;
+bool wifiMgrFastReconnect = true;
+bool wifiMgrFastReconnectPersist = false;
+bool wifiMgrFastAttempt = false;
+bool wifiMgrFastCacheLoaded = false;
+
+// last successful BSSID, channel and DHCP lease
+struct WifiMgrFastConnectCache {
+    uint32_t magic;
+    uint32_t ssidHash;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t checksum;
+};
+WifiMgrFastConnectCache wifiMgrFastCache = {};
+
+// static address, or the previous lease applied right away and renewed once connected
+IPAddress wifiMgrStaticIP((uint32_t) 0);
+IPAddress wifiMgrStaticGateway((uint32_t) 0);
+IPAddress wifiMgrStaticSubnet((uint32_t) 0);
+IPAddress wifiMgrStaticDNS((uint32_t) 0);
+bool wifiMgrReuseLease = false;
+bool wifiMgrLeaseReused = false;
+bool wifiMgrIPConfigured = false;
+unsigned long wifiMgrLeaseConfirmDelayMs = 5000;
+
+// best candidate of the current scan, which may consist of several single channel passes
+WifiMgrScanPolicy wifiMgrScanPolicy = WIFI_MGR_SCAN_ALL;
+uint16_t wifiMgrLearnedChannels = 0; // bit n set = SSID was seen on channel n
+uint16_t wifiMgrScanChannels = 0; // channels still to scan in this attempt
+bool wifiMgrScannedAllChannels = false;
+uint8_t wifiMgrBestBSSID[6];
+int32_t wifiMgrBestRSSI = -999;
+int32_t wifiMgrBestChannel = 0;
+int32_t wifiMgrBestScore = -999;
+uint8_t wifiMgrBestNetwork = 0;
+uint8_t wifiMgrCurrentBSSID[6];
+int32_t wifiMgrCurrentRSSI = -999;
+
+// additional networks in priority order, the one passed to setupWifi() always comes first
+struct WifiMgrNetwork {
+    char* ssid = nullptr;
+    char* password = nullptr;
+};
+WifiMgrNetwork wifiMgrNetworks[WIFI_MGR_MAX_NETWORKS - 1];
+uint8_t wifiMgrNetworkCount = 0;
+uint8_t wifiMgrNetworkIndex = 0; // network of the current / last attempt
+uint8_t wifiMgrNetworkPriorityPenalty = 10; // dB per priority step
+
+// connection history per BSSID, used to rank candidates beyond their RSSI
+struct WifiMgrBssidHistory {
+    uint8_t bssid[6];
+    uint8_t attempts;
+    uint8_t successes;
+    int8_t avgRSSI;
+    uint16_t avgTimeToIP; // ms
+    unsigned long lastUsed;
+    uint8_t failStreak; // consecutive failures, drives the blacklist backoff
+    unsigned long blockedSince;
+    unsigned long blockedFor;
+};
+WifiMgrBssidHistory wifiMgrBssidHistory[WIFI_MGR_MAX_BSSID_HISTORY];
+WifiMgrBssidHistory* wifiMgrAttemptHistory = nullptr;
+unsigned long wifiMgrAttemptStart = 0;
+unsigned long wifiMgrBlacklistBaseMs = 20 * 1000; // doubled per consecutive failure
+unsigned long wifiMgrBlacklistMaxMs = 20 * 60 * 1000; // 20m
+unsigned long wifiMgrRetryBaseMs = 10 * 1000; // doubled per unsuccessful try
+unsigned long wifiMgrRetryMaxMs = 5 * 60 * 1000; // 5m
+unsigned long wifiMgrRetryDelayMs = 10 * 1000;
+#if defined(ESP32)
+RTC_DATA_ATTR WifiMgrFastConnectCache wifiMgrRtcFastCache;
+#endif
 
 #if defined(ESP32)
 static bool mdnsInitialized = false;
 #endif
 
+// link state as reported by the platform WiFi event handlers (event task on ESP32), only they write it
+std::atomic<bool> wifiMgrEventAssociated(false);
+std::atomic<uint32_t> wifiMgrEventIP(0);
+std::atomic<uint32_t> wifiMgrEventChanges(0);
+// the main loop's copy, picked up whenever wifiMgrEventChanges moves
+bool wifiMgrLinkAssociated = false;
+uint32_t wifiMgrLinkIP = 0;
+uint32_t wifiMgrLinkChangesSeen = 0;
+bool wifiMgrEventsRegistered = false;
+#if defined(ESP8266)
+WiFiEventHandler wifiMgrConnectedHandler;
+WiFiEventHandler wifiMgrDisconnectedHandler;
+WiFiEventHandler wifiMgrGotIPHandler;
+WiFiEventHandler wifiMgrDHCPTimeoutHandler;
+#elif defined(ESP32)
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 2
+#define WIFI_MGR_EVENT_STA_CONNECTED ARDUINO_EVENT_WIFI_STA_CONNECTED
+#define WIFI_MGR_EVENT_STA_DISCONNECTED ARDUINO_EVENT_WIFI_STA_DISCONNECTED
+#define WIFI_MGR_EVENT_STA_GOT_IP ARDUINO_EVENT_WIFI_STA_GOT_IP
+#define WIFI_MGR_EVENT_STA_LOST_IP ARDUINO_EVENT_WIFI_STA_LOST_IP
+typedef arduino_event_id_t WifiMgrEventId;
+typedef arduino_event_info_t WifiMgrEventInfo;
+#else
+#define WIFI_MGR_EVENT_STA_CONNECTED SYSTEM_EVENT_STA_CONNECTED
+#define WIFI_MGR_EVENT_STA_DISCONNECTED SYSTEM_EVENT_STA_DISCONNECTED
+#define WIFI_MGR_EVENT_STA_GOT_IP SYSTEM_EVENT_STA_GOT_IP
+#define WIFI_MGR_EVENT_STA_LOST_IP SYSTEM_EVENT_STA_LOST_IP
+typedef system_event_id_t WifiMgrEventId;
+typedef system_event_info_t WifiMgrEventInfo;
+#endif
+#endif
+
 int8_t badRSS = -70;
 const char* wifiMgrSSID = nullptr;
 const char* wifiMgrPW = nullptr;
@@ -42,6 +180,15 @@ void (*wifiMgrNotifyNoWifiCallback)(void) = nullptr;
 
 XWebServer *wifiMgrServer = nullptr;
 
+const char* wifiMgrPhaseNames[] = {"idle", "disconnecting", "scanning", "selecting", "associating", "dhcp", "connected"};
+
+// keeps a running softAP (portal) up while connecting
+bool wifiMgrKeepAP = false;
+
+WiFiMode_t wifiMgrStationMode() {
+    return wifiMgrKeepAP ? WIFI_AP_STA : WIFI_STA;
+}
+
 boolean waitForWifi(unsigned long timeout) {
     unsigned long waitForConnectStart = millis();
     while (!WiFi.isConnected() && (millis() - waitForConnectStart) < timeout) {
@@ -75,9 +222,7 @@ void wifiNotifyUnsuccessfullTry() {
     }
 }
 
-void connectToWifi() {
-    //if (wifiMgrServer != nullptr) wifiMgrServer->stop();
-    //if (wifiMgrServer != nullptr) wifiMgrServer->close();
+void wifiMgrStopMdns() {
 #if defined(ESP8266)
     if (wifiMgrMdns.isRunning()) wifiMgrMdns.end();
 #elif defined(ESP32)
@@ -86,94 +231,669 @@ void connectToWifi() {
         mdnsInitialized = false;
     }
 #endif
+}
 
-    WiFi.disconnect(true);
-    waitForDisconnect(3000);
-    WiFi.mode(WIFI_STA);
+const char* wifiMgrGetNetworkSSID(uint8_t index) {
+    return index == 0 ? wifiMgrSSID : wifiMgrNetworks[index - 1].ssid;
+}
 
-    wifiMgrScanCount++;
+const char* wifiMgrGetNetworkPassword(uint8_t index) {
+    return index == 0 ? wifiMgrPW : wifiMgrNetworks[index - 1].password;
+}
 
-    int n = WiFi.scanNetworks(true, false, 0);
+// returns the priority index of the network with this SSID or -1
+int wifiMgrFindNetwork(const String& ssid) {
+    for (uint8_t i = 0; i <= wifiMgrNetworkCount; i++) {
+        const char* networkSSID = wifiMgrGetNetworkSSID(i);
+        if (networkSSID != nullptr && ssid.equals(networkSSID)) return i;
+    }
+    return -1;
+}
 
-    unsigned long waitForScanStart = millis();
+WifiMgrBssidHistory* wifiMgrFindBssidHistory(const uint8_t* bssid, bool create) {
+    WifiMgrBssidHistory* oldest = &wifiMgrBssidHistory[0];
+    unsigned long now = millis();
+    for (int i = 0; i < WIFI_MGR_MAX_BSSID_HISTORY; i++) {
+        WifiMgrBssidHistory* entry = &wifiMgrBssidHistory[i];
+        if (entry->lastUsed != 0 && memcmp(entry->bssid, bssid, 6) == 0) return entry;
+        // free entries first, then the one unused for the longest time. Ages, so a millis() wrap does not matter
+        if (oldest->lastUsed != 0 && (entry->lastUsed == 0 || now - entry->lastUsed > now - oldest->lastUsed)) oldest = entry;
+    }
+    if (!create) return nullptr;
+    memset(oldest, 0, sizeof(WifiMgrBssidHistory));
+    memcpy(oldest->bssid, bssid, 6);
+    oldest->lastUsed = millis() | 1;
+    return oldest;
+}
 
-    while (WiFi.scanComplete() == -1 && (millis() - waitForScanStart) < wifiMgrWaitForScanMs) {
-        if (loopFunctionPointer != nullptr) loopFunctionPointer();
-        yield();
+// true while the backoff of the last failures of this BSSID is running
+bool wifiMgrIsBlacklisted(const WifiMgrBssidHistory* history) {
+    return history != nullptr && history->blockedFor > 0 && (millis() - history->blockedSince) < history->blockedFor;
+}
+
+// higher is better. starts from the RSSI, blended with the average seen for this BSSID, and subtracts penalties for
+// the network priority, the failure rate and a slow time to IP. blacklisted BSSIDs only win if there is nothing else
+int32_t wifiMgrScoreCandidate(const uint8_t* bssid, int32_t rssi, uint8_t networkIndex) {
+    WifiMgrBssidHistory* history = wifiMgrFindBssidHistory(bssid, false);
+    // a single scan sample is noisy
+    if (history != nullptr && history->avgRSSI != 0) rssi = (rssi + history->avgRSSI) / 2;
+    int32_t score = rssi - networkIndex * wifiMgrNetworkPriorityPenalty;
+    if (history != nullptr && history->attempts > 0) {
+        score -= 30 * (history->attempts - history->successes) / history->attempts;
+        score -= history->avgTimeToIP / 1000 > 10 ? 10 : history->avgTimeToIP / 1000;
     }
-    n = WiFi.scanComplete();
+    if (wifiMgrIsBlacklisted(history)) score -= 1000;
+    return score;
+}
 
-    if (n > 0) {
-        String ssid;
-        uint8_t encryptionType;
-        int32_t RSSI;
-        uint8_t *BSSID;
-        int32_t channel;
-        bool isHidden = false;
+uint32_t wifiMgrRandom() {
+#if defined(ESP8266)
+    return ESP.random();
+#elif defined(ESP32)
+    return esp_random();
+#endif
+}
 
-        uint8_t bestBSSID[6];
-        int32_t bestRSSI = -999;
-        int32_t bestChannel = 0;
+// exponential backoff with +-25% jitter, so a fleet does not retry in lockstep after an outage
+unsigned long wifiMgrBackoff(unsigned long base, unsigned long max, uint8_t exponent) {
+    unsigned long delay = base << (exponent > 8 ? 8 : exponent);
+    if (delay > max) delay = max;
+    return delay / 4 * 3 + wifiMgrRandom() % (delay / 2 + 1);
+}
 
-        for (int i = 0; i < n; i++) {
+void wifiMgrRecordFailure() {
+    WifiMgrBssidHistory* history = wifiMgrAttemptHistory;
+    wifiMgrAttemptHistory = nullptr;
+    if (history == nullptr) return;
+    if (history->failStreak < 255) history->failStreak++;
+    history->blockedSince = millis();
+    history->blockedFor = wifiMgrBackoff(wifiMgrBlacklistBaseMs, wifiMgrBlacklistMaxMs, history->failStreak - 1);
+}
+
+void wifiMgrRecordAttempt(const uint8_t* bssid) {
+    wifiMgrAttemptHistory = wifiMgrFindBssidHistory(bssid, true);
+    if (wifiMgrAttemptHistory->attempts == 255) {
+        // keep the ratio but let recent results weigh more
+        wifiMgrAttemptHistory->attempts /= 2;
+        wifiMgrAttemptHistory->successes /= 2;
+    }
+    wifiMgrAttemptHistory->attempts++;
+    wifiMgrAttemptHistory->lastUsed = millis() | 1;
+    wifiMgrAttemptStart = millis();
+}
+
+void wifiMgrRecordSuccess(unsigned long timeToIP) {
+    WifiMgrBssidHistory* history = wifiMgrAttemptHistory;
+    wifiMgrAttemptHistory = nullptr;
+    if (history == nullptr) return;
+    if (timeToIP > 65535) timeToIP = 65535;
+    int8_t rssi = WiFi.RSSI();
+    bool first = history->successes == 0;
+    history->successes++;
+    history->failStreak = 0;
+    history->blockedFor = 0;
+    history->avgTimeToIP = first ? timeToIP : (history->avgTimeToIP * 3 + timeToIP) / 4;
+    history->avgRSSI = first ? rssi : (history->avgRSSI * 3 + rssi) / 4;
+}
+
+uint32_t wifiMgrSsidHash(const char* ssid) {
+    uint32_t hash = 2166136261UL;
+    while (ssid != nullptr && *ssid) {
+        hash ^= (uint8_t) *ssid++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+uint8_t wifiMgrFastCacheChecksum(const WifiMgrFastConnectCache& cache) {
+    const uint8_t* bytes = (const uint8_t*) &cache;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < offsetof(WifiMgrFastConnectCache, checksum); i++) sum += bytes[i];
+    return ~sum;
+}
+
+// returns the network the cached AP belongs to or -1
+int wifiMgrFastCacheNetwork() {
+    if (wifiMgrFastCache.magic != WIFI_MGR_FAST_CONNECT_MAGIC || wifiMgrFastCache.checksum != wifiMgrFastCacheChecksum(wifiMgrFastCache)) return -1;
+    for (uint8_t i = 0; i <= wifiMgrNetworkCount; i++) {
+        const char* ssid = wifiMgrGetNetworkSSID(i);
+        if (ssid != nullptr && wifiMgrFastCache.ssidHash == wifiMgrSsidHash(ssid)) return i;
+    }
+    return -1;
+}
+
+bool wifiMgrFastCacheValid() {
+    return wifiMgrFastCacheNetwork() >= 0;
+}
+
+// prefers the RTC copy (survives deep sleep), falls back to the config store
+void wifiMgrLoadFastCache() {
+    if (wifiMgrFastCacheLoaded) return;
+    wifiMgrFastCacheLoaded = true;
 #if defined(ESP8266)
-            WiFi.getNetworkInfo(i, ssid, encryptionType, RSSI, BSSID, channel, isHidden);
+    ESP.rtcUserMemoryRead(WIFI_MGR_RTC_OFFSET, (uint32_t*) &wifiMgrFastCache, sizeof(wifiMgrFastCache));
 #elif defined(ESP32)
-            WiFi.getNetworkInfo(i, ssid, encryptionType, RSSI, BSSID, channel);
-	    isHidden = false;
+    wifiMgrFastCache = wifiMgrRtcFastCache;
 #endif
+    if (wifiMgrFastCacheValid()) {
+        if (wifiMgrFastCache.channel <= 14) wifiMgrLearnedChannels |= 1 << wifiMgrFastCache.channel;
+        return;
+    }
+    if (!wifiMgrFastReconnectPersist) return;
 
-            if (!isHidden && ssid.equals(wifiMgrSSID) && RSSI > bestRSSI) {
-                bestRSSI = RSSI;
-                memcpy(bestBSSID, BSSID, 6);
-                bestChannel = channel;
-            }
-        }
+    // stored as "bssid,channel,ssidhash" in hex, older versions did not pad channel and hash
+    const char* stored = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("WM_BSSID"));
+    unsigned int b[6];
+    unsigned int channel;
+    unsigned long ssidHash;
+    if (stored == nullptr || sscanf(stored, "%2x%2x%2x%2x%2x%2x,%u,%lx", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5], &channel, &ssidHash) != 8) {
+        wifiMgrFastCache.magic = 0;
+        return;
+    }
+    wifiMgrFastCache.magic = WIFI_MGR_FAST_CONNECT_MAGIC;
+    wifiMgrFastCache.ssidHash = ssidHash;
+    for (int i = 0; i < 6; i++) wifiMgrFastCache.bssid[i] = b[i];
+    wifiMgrFastCache.channel = channel;
+    wifiMgrFastCache.checksum = wifiMgrFastCacheChecksum(wifiMgrFastCache);
+    if (channel > 0 && channel <= 14) wifiMgrLearnedChannels |= 1 << channel;
+}
 
-        if (bestRSSI != -999) {
-            WiFi.begin(wifiMgrSSID, wifiMgrPW, bestChannel, bestBSSID);
-            uint8_t status = WiFi.waitForConnectResult();
-            wifiMgrConnectCount++;
-            if (status != WL_CONNECTED) {
-                WiFi.disconnect(true);
-                WiFi.mode(WIFI_OFF);
-                waitForDisconnect(3000);
-                wifiNotifyUnsuccessfullTry();
-            } else {
-                wifiMgrUnsuccessfullTries = 0;
-                if (wifiMgrHN != nullptr && strlen(wifiMgrHN) > 0) {
+void wifiMgrStoreFastCache() {
+    WifiMgrFastConnectCache cache = {};
+    cache.magic = WIFI_MGR_FAST_CONNECT_MAGIC;
+    cache.ssidHash = wifiMgrSsidHash(wifiMgrGetNetworkSSID(wifiMgrNetworkIndex));
+    memcpy(cache.bssid, WiFi.BSSID(), 6);
+    cache.channel = WiFi.channel();
+    cache.ip = WiFi.localIP();
+    cache.gateway = WiFi.gatewayIP();
+    cache.subnet = WiFi.subnetMask();
+    cache.dns = WiFi.dnsIP();
+    cache.checksum = wifiMgrFastCacheChecksum(cache);
+    bool changed = memcmp(&cache, &wifiMgrFastCache, sizeof(cache)) != 0;
+    wifiMgrFastCache = cache;
+    wifiMgrFastCacheLoaded = true;
+    if (cache.channel > 0 && cache.channel <= 14) wifiMgrLearnedChannels |= 1 << cache.channel;
 #if defined(ESP8266)
-                    if (wifiMgrMdns.isRunning()) wifiMgrMdns.end();
-                    wifiMgrMdns.begin(wifiMgrHN, WiFi.localIP());
+    if (changed) ESP.rtcUserMemoryWrite(WIFI_MGR_RTC_OFFSET, (uint32_t*) &wifiMgrFastCache, sizeof(wifiMgrFastCache));
 #elif defined(ESP32)
-                    esp_err_t err = mdns_init();
-                    if (err == ESP_OK) {
-                        mdns_hostname_set(wifiMgrHN);
-                        mdnsInitialized = true;
-                    }
+    wifiMgrRtcFastCache = wifiMgrFastCache;
 #endif
-                }
+    if (changed && wifiMgrFastReconnectPersist) {
+        // fixed width, so it is overwritten in place and does not move other config values around
+        char value[32];
+        snprintf(value, sizeof(value), "%02x%02x%02x%02x%02x%02x,%02u,%08lx", cache.bssid[0], cache.bssid[1], cache.bssid[2],
+                 cache.bssid[3], cache.bssid[4], cache.bssid[5], cache.channel, (unsigned long) cache.ssidHash);
+        const char* stored = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("WM_BSSID"));
+        if (stored == nullptr || strcmp(stored, value) != 0) {
+            if (wifiMgrSetConfig("WM_BSSID", value)) wifiMgrCommitEEPROM();
+        }
+    }
+}
+
+void wifiMgrPublishLinkState(bool associated, uint32_t ip) {
+    wifiMgrEventAssociated.store(associated);
+    wifiMgrEventIP.store(ip);
+    // bumped last, a reader that raced the stores above sees the counter move again and rereads
+    wifiMgrEventChanges.fetch_add(1);
+}
+
+// true if the event handlers reported something new since the last call
+bool wifiMgrSyncLinkState() {
+    uint32_t changes = wifiMgrEventChanges.load();
+    if (changes == wifiMgrLinkChangesSeen) return false;
+    wifiMgrLinkChangesSeen = changes;
+    wifiMgrLinkAssociated = wifiMgrEventAssociated.load();
+    wifiMgrLinkIP = wifiMgrEventIP.load();
+    return true;
+}
+
+// main loop override (own disconnect, static IP), events up to now are treated as consumed
+void wifiMgrSetLinkState(bool associated, uint32_t ip) {
+    wifiMgrLinkChangesSeen = wifiMgrEventChanges.load();
+    wifiMgrLinkAssociated = associated;
+    wifiMgrLinkIP = ip;
+}
 
+void wifiMgrRegisterEvents() {
+    if (wifiMgrEventsRegistered) return;
+    wifiMgrEventsRegistered = true;
 #if defined(ESP8266)
-                // status 0 means the server is closed - so not running (I think)
-                if (wifiMgrServer != nullptr && wifiMgrServer->getServer().status() == 0) wifiMgrServer->begin();
+    wifiMgrConnectedHandler = WiFi.onStationModeConnected([](const WiFiEventStationModeConnected&) {
+        wifiMgrPublishLinkState(true, 0);
+    });
+    wifiMgrDisconnectedHandler = WiFi.onStationModeDisconnected([](const WiFiEventStationModeDisconnected&) {
+        wifiMgrPublishLinkState(false, 0);
+    });
+    wifiMgrGotIPHandler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP& event) {
+        wifiMgrPublishLinkState(true, (uint32_t) event.ip);
+    });
+    wifiMgrDHCPTimeoutHandler = WiFi.onStationModeDHCPTimeout([]() {
+        wifiMgrPublishLinkState(wifiMgrEventAssociated.load(), 0);
+    });
 #elif defined(ESP32)
-                wifiMgrServer->begin();
+    WiFi.onEvent([](WifiMgrEventId, WifiMgrEventInfo) {
+        wifiMgrPublishLinkState(true, 0);
+    }, WIFI_MGR_EVENT_STA_CONNECTED);
+    WiFi.onEvent([](WifiMgrEventId, WifiMgrEventInfo) {
+        wifiMgrPublishLinkState(false, 0);
+    }, WIFI_MGR_EVENT_STA_DISCONNECTED);
+    WiFi.onEvent([](WifiMgrEventId, WifiMgrEventInfo info) {
+        wifiMgrPublishLinkState(true, info.got_ip.ip_info.ip.addr);
+    }, WIFI_MGR_EVENT_STA_GOT_IP);
+    WiFi.onEvent([](WifiMgrEventId, WifiMgrEventInfo) {
+        wifiMgrPublishLinkState(wifiMgrEventAssociated.load(), 0);
+    }, WIFI_MGR_EVENT_STA_LOST_IP);
 #endif
-                wifiMgrLastNonShitRSS = millis();
-                wifiMgrInvalidRSSISince = 0;
-                wifiMgrInvalidIPSince = 0;
-            }
-        } else {
-            wifiNotifyUnsuccessfullTry();
+}
+
+uint16_t wifiMgrTraceDuration(unsigned long since) {
+    unsigned long duration = millis() - since;
+    return duration > 65535 ? 65535 : duration;
+}
+
+void wifiMgrSetPhase(WifiMgrConnectPhase phase) {
+    if (wifiMgrTrace != nullptr) {
+        // account the time spent in the phase that ends now
+        uint16_t duration = wifiMgrTraceDuration(wifiMgrPhaseSince);
+        if (wifiMgrPhase == WIFI_MGR_DISCONNECTING) wifiMgrTrace->disconnectMs += duration;
+        else if (wifiMgrPhase == WIFI_MGR_SCANNING || wifiMgrPhase == WIFI_MGR_SELECTING) wifiMgrTrace->scanMs += duration;
+        else if (wifiMgrPhase == WIFI_MGR_ASSOCIATING) wifiMgrTrace->associateMs += duration;
+        else if (wifiMgrPhase == WIFI_MGR_DHCP) wifiMgrTrace->dhcpMs += duration;
+    }
+    wifiMgrPhase = phase;
+    wifiMgrPhaseSince = millis();
+}
+
+void wifiMgrTraceEnd(WifiMgrTraceResult result) {
+    if (wifiMgrTrace == nullptr) return;
+    wifiMgrTrace->result = result;
+    if (wifiMgrTrace->scanMs > 0) wifiMgrStatsObserve(WIFI_MGR_HISTOGRAM_SCAN, wifiMgrTrace->scanMs * 1000UL);
+    if (result == WIFI_MGR_TRACE_CONNECTED) wifiMgrStatsObserve(WIFI_MGR_HISTOGRAM_CONNECT, (millis() - wifiMgrTrace->start) * 1000UL);
+    wifiMgrTrace = nullptr;
+}
+
+bool wifiMgrIsConnecting() {
+    return wifiMgrPhase != WIFI_MGR_IDLE && wifiMgrPhase != WIFI_MGR_CONNECTED;
+}
+
+void wifiMgrConnectFailed() {
+    wifiMgrRecordFailure();
+    if (wifiMgrFastAttempt) {
+        // the cached AP did not work out, fall back to a full scan without counting a failed try
+        wifiMgrFastAttempt = false;
+        wifiMgrFastCache.magic = 0;
+        WiFi.disconnect(true);
+        wifiMgrSetPhase(WIFI_MGR_DISCONNECTING);
+        return;
+    }
+    WiFi.disconnect(true);
+    WiFi.mode(wifiMgrKeepAP ? WIFI_AP : WIFI_OFF);
+    wifiMgrLastScan = millis();
+    wifiMgrSetPhase(WIFI_MGR_IDLE);
+    wifiMgrTraceEnd(WIFI_MGR_TRACE_FAILED);
+    wifiNotifyUnsuccessfullTry();
+    // the first retry waits the base delay, like the blacklist
+    wifiMgrRetryDelayMs = wifiMgrBackoff(wifiMgrRetryBaseMs, wifiMgrRetryMaxMs, wifiMgrUnsuccessfullTries - 1);
+}
+
+void wifiMgrConnectSucceeded() {
+    wifiMgrSetPhase(WIFI_MGR_CONNECTED);
+    wifiMgrUnsuccessfullTries = 0;
+    wifiMgrRetryDelayMs = wifiMgrBackoff(wifiMgrRetryBaseMs, wifiMgrRetryMaxMs, 0);
+    if (wifiMgrFastAttempt) wifiMgrFastConnectCount++;
+    wifiMgrRecordSuccess(millis() - wifiMgrAttemptStart);
+    if (wifiMgrBootConnectMs == 0) {
+        wifiMgrBootConnectMs = millis();
+        wifiMgrBootFastPath = wifiMgrFastAttempt;
+    }
+    wifiMgrFastAttempt = false;
+    if (wifiMgrFastReconnect) wifiMgrStoreFastCache();
+    unsigned long traceStart = millis();
+    if (wifiMgrHN != nullptr && strlen(wifiMgrHN) > 0) {
+#if defined(ESP8266)
+        if (wifiMgrMdns.isRunning()) wifiMgrMdns.end();
+        wifiMgrMdns.begin(wifiMgrHN, WiFi.localIP());
+#elif defined(ESP32)
+        esp_err_t err = mdns_init();
+        if (err == ESP_OK) {
+            mdns_hostname_set(wifiMgrHN);
+            mdnsInitialized = true;
         }
-    } else {
-        wifiNotifyUnsuccessfullTry();
+#endif
     }
+    if (wifiMgrTrace != nullptr) wifiMgrTrace->mdnsMs = wifiMgrTraceDuration(traceStart);
+
+    traceStart = millis();
+#if defined(ESP8266)
+    // status 0 means the server is closed - so not running (I think)
+    if (wifiMgrServer != nullptr && wifiMgrServer->getServer().status() == 0) wifiMgrServer->begin();
+#elif defined(ESP32)
+    if (wifiMgrServer != nullptr) wifiMgrServer->begin();
+#endif
+    if (wifiMgrTrace != nullptr) wifiMgrTrace->serverMs = wifiMgrTraceDuration(traceStart);
+    wifiMgrLastNonShitRSS = millis();
+    wifiMgrInvalidRSSISince = 0;
+    wifiMgrInvalidIPSince = 0;
+    wifiMgrStatsResetSmoothing();
     wifiMgrLastScan = millis();
+    wifiMgrTraceEnd(WIFI_MGR_TRACE_CONNECTED);
+}
+
+// static address, a reused lease or DHCP
+void wifiMgrApplyIPConfig(uint8_t networkIndex) {
+    wifiMgrLeaseReused = false;
+    if ((uint32_t) wifiMgrStaticIP != 0) {
+        WiFi.config(wifiMgrStaticIP, wifiMgrStaticGateway, wifiMgrStaticSubnet, wifiMgrStaticDNS);
+        wifiMgrIPConfigured = true;
+    } else if (wifiMgrReuseLease && wifiMgrFastCache.ip != 0 && wifiMgrFastCacheNetwork() == networkIndex) {
+        WiFi.config(IPAddress(wifiMgrFastCache.ip), IPAddress(wifiMgrFastCache.gateway), IPAddress(wifiMgrFastCache.subnet), IPAddress(wifiMgrFastCache.dns));
+        wifiMgrIPConfigured = true;
+        wifiMgrLeaseReused = true;
+    } else if (wifiMgrIPConfigured) {
+        WiFi.config(IPAddress((uint32_t) 0), IPAddress((uint32_t) 0), IPAddress((uint32_t) 0));
+        wifiMgrIPConfigured = false;
+    }
+}
+
+void wifiMgrBegin(uint8_t networkIndex, int32_t channel, const uint8_t* bssid) {
+    wifiMgrNetworkIndex = networkIndex;
+    wifiMgrApplyIPConfig(networkIndex);
+    WiFi.begin(wifiMgrGetNetworkSSID(networkIndex), wifiMgrGetNetworkPassword(networkIndex), channel, bssid);
+    wifiMgrRecordAttempt(bssid);
+    wifiMgrConnectCount++;
+    if (wifiMgrTrace != nullptr) {
+        memcpy(wifiMgrTrace->bssid, bssid, 6);
+        wifiMgrTrace->channel = channel;
+    }
+    wifiMgrSetPhase(WIFI_MGR_ASSOCIATING);
+}
+
+void wifiMgrScanChannel(uint8_t channel) {
+    // directed probe for the configured SSID unless every network was requested.
+    // a probe can only carry one SSID, so with several networks every SSID is scanned
+    const char* ssid = wifiMgrScanPolicy == WIFI_MGR_SCAN_ALL || wifiMgrNetworkCount > 0 ? nullptr : wifiMgrSSID;
+    if (channel == 0) wifiMgrScannedAllChannels = true;
+#if defined(ESP8266)
+    WiFi.scanNetworks(true, false, channel, (uint8_t*) ssid);
+#elif defined(ESP32)
+    WiFi.scanNetworks(true, false, false, 300, channel, ssid);
+#endif
+    wifiMgrSetPhase(WIFI_MGR_SCANNING);
+}
+
+// starts the scan of the next pending channel. returns false if there is none left
+bool wifiMgrScanNextChannel() {
+    for (uint8_t channel = 1; channel <= 14; channel++) {
+        if (wifiMgrScanChannels & (1 << channel)) {
+            wifiMgrScanChannels &= ~(1 << channel);
+            wifiMgrScanChannel(channel);
+            return true;
+        }
+    }
+    return false;
+}
+
+void wifiMgrStartScan() {
+    wifiMgrScanCount++;
+    wifiMgrBestRSSI = -999;
+    wifiMgrBestScore = -999;
+    wifiMgrCurrentRSSI = -999;
+    memset(wifiMgrCurrentBSSID, 0, 6);
+    if (wifiMgrRoamScan && wifiMgrLinkAssociated) {
+        memcpy(wifiMgrCurrentBSSID, WiFi.BSSID(), 6);
+        wifiMgrCurrentRSSI = WiFi.RSSI();
+    }
+    wifiMgrScannedAllChannels = false;
+    wifiMgrScanChannels = wifiMgrScanPolicy == WIFI_MGR_SCAN_LEARNED_CHANNELS ? wifiMgrLearnedChannels : 0;
+    if (!wifiMgrScanNextChannel()) wifiMgrScanChannel(0);
+}
+
+// keeps the best candidate of every scan pass and frees the results right away
+void wifiMgrEvaluateScanResults() {
+    int n = WiFi.scanComplete();
+    String ssid;
+    uint8_t encryptionType;
+    int32_t RSSI;
+    uint8_t *BSSID;
+    int32_t channel;
+    bool isHidden = false;
+
+    if (wifiMgrTrace != nullptr && n > 0) wifiMgrTrace->networks += n;
+    for (int i = 0; i < n; i++) {
+#if defined(ESP8266)
+        WiFi.getNetworkInfo(i, ssid, encryptionType, RSSI, BSSID, channel, isHidden);
+#elif defined(ESP32)
+        WiFi.getNetworkInfo(i, ssid, encryptionType, RSSI, BSSID, channel);
+        isHidden = false;
+#endif
+
+        if (isHidden) continue;
+        int network = wifiMgrFindNetwork(ssid);
+        if (network < 0) continue;
+        if (channel > 0 && channel <= 14) wifiMgrLearnedChannels |= 1 << channel;
+        WifiMgrBssidHistory* history = wifiMgrFindBssidHistory(BSSID, false);
+        if (history != nullptr) history->avgRSSI = history->avgRSSI == 0 ? RSSI : (history->avgRSSI * 3 + RSSI) / 4;
+        // compare the current AP using the same measurement as the candidates
+        if (wifiMgrRoamScan && memcmp(BSSID, wifiMgrCurrentBSSID, 6) == 0) wifiMgrCurrentRSSI = RSSI;
+        int32_t score = wifiMgrScoreCandidate(BSSID, RSSI, network);
+        if (wifiMgrBestRSSI == -999 || score > wifiMgrBestScore) {
+            wifiMgrBestRSSI = RSSI;
+            wifiMgrBestScore = score;
+            wifiMgrBestNetwork = network;
+            memcpy(wifiMgrBestBSSID, BSSID, 6);
+            wifiMgrBestChannel = channel;
+        }
+    }
     WiFi.scanDelete();
 }
 
+void wifiMgrSelectBestNetwork() {
+    bool keepLink = wifiMgrRoamScan && wifiMgrLinkAssociated;
+    wifiMgrRoamScan = false;
+
+    if (keepLink) {
+        // make before break: only re-associate if a clearly better BSSID exists
+        int32_t currentScore = wifiMgrScoreCandidate(wifiMgrCurrentBSSID, wifiMgrCurrentRSSI, wifiMgrNetworkIndex);
+        if (wifiMgrBestRSSI == -999 || memcmp(wifiMgrBestBSSID, wifiMgrCurrentBSSID, 6) == 0 || wifiMgrBestScore < currentScore + wifiMgrRoamHysteresis) {
+            wifiMgrLastScan = millis();
+            wifiMgrSetPhase(WIFI_MGR_CONNECTED);
+            wifiMgrTraceEnd(WIFI_MGR_TRACE_KEPT);
+            return;
+        }
+        wifiMgrRoamCount++;
+        wifiMgrStopMdns();
+        WiFi.disconnect(false);
+        wifiMgrSetLinkState(false, 0);
+    }
+
+    if (wifiMgrBestRSSI != -999) {
+        wifiMgrBegin(wifiMgrBestNetwork, wifiMgrBestChannel, wifiMgrBestBSSID);
+    } else {
+        wifiMgrConnectFailed();
+    }
+}
+
+// advances the connection by one phase. returns true if the phase changed
+bool wifiMgrConnectStep() {
+    wifiMgrSyncLinkState();
+    switch (wifiMgrPhase) {
+        case WIFI_MGR_DISCONNECTING:
+            if (WiFi.status() == WL_CONNECTED && (millis() - wifiMgrPhaseSince) < 3000) return false;
+            WiFi.mode(wifiMgrStationMode());
+            if (wifiMgrFastAttempt && wifiMgrFastCacheValid()) {
+                // skip the scan and go straight to the last known AP
+                wifiMgrBegin(wifiMgrFastCacheNetwork(), wifiMgrFastCache.channel, wifiMgrFastCache.bssid);
+                return true;
+            }
+            wifiMgrFastAttempt = false;
+            wifiMgrStartScan();
+            return true;
+        case WIFI_MGR_SCANNING:
+            if (WiFi.scanComplete() == WIFI_SCAN_RUNNING && (millis() - wifiMgrPhaseSince) < wifiMgrWaitForScanMs) return false;
+            wifiMgrSetPhase(WIFI_MGR_SELECTING);
+            return true;
+        case WIFI_MGR_SELECTING:
+            wifiMgrEvaluateScanResults();
+            if (wifiMgrScanNextChannel()) return true;
+            // the SSID was not found on the learned channels, try all of them once
+            if (wifiMgrBestRSSI == -999 && !wifiMgrScannedAllChannels) {
+                wifiMgrScanChannel(0);
+                return true;
+            }
+            wifiMgrSelectBestNetwork();
+            return true;
+        case WIFI_MGR_ASSOCIATING: {
+            wl_status_t status = WiFi.status();
+            if (wifiMgrLinkAssociated || status == WL_CONNECTED) {
+                wifiMgrSetPhase(WIFI_MGR_DHCP);
+                return true;
+            }
+            bool failed = status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL || status == WL_CONNECTION_LOST;
+#if defined(ESP8266)
+            failed = failed || status == WL_WRONG_PASSWORD;
+#endif
+            if (!failed && (millis() - wifiMgrPhaseSince) < wifiMgrWaitForConnectMs) return false;
+            wifiMgrConnectFailed();
+            return true;
+        }
+        case WIFI_MGR_DHCP:
+            // a static address does not necessarily come with a got-IP event
+            if (wifiMgrLinkIP == 0 && wifiMgrIPConfigured && (uint32_t) WiFi.localIP() != 0) {
+                wifiMgrSetLinkState(true, WiFi.localIP());
+            }
+            if (wifiMgrLinkIP != 0) {
+                wifiMgrConnectSucceeded();
+                return true;
+            }
+            if ((millis() - wifiMgrPhaseSince) < wifiMgrInvalidIPTimeout) return false;
+            wifiMgrInvalidIPCount++;
+            wifiMgrConnectFailed();
+            return true;
+        case WIFI_MGR_IDLE:
+        case WIFI_MGR_CONNECTED:
+        default:
+            return false;
+    }
+}
+
+void wifiMgrRunConnectSteps() {
+    unsigned long start = millis();
+    while (wifiMgrConnectStep() && wifiMgrIsConnecting() && (millis() - start) < wifiMgrConnectStepBudgetMs) {
+        yield();
+    }
+}
+
+void wifiMgrConnect() {
+    if (wifiMgrIsConnecting()) return;
+    if (wifiMgrFastReconnect) wifiMgrLoadFastCache();
+    // a reconnect from a working link (bad RSSI, missing IP) is meant to pick a different AP, so it always scans
+    wifiMgrFastAttempt = wifiMgrFastReconnect && !wifiMgrLinkAssociated && wifiMgrFastCacheValid();
+    wifiMgrStopMdns();
+    WiFi.disconnect(true);
+    wifiMgrSetLinkState(false, 0);
+    wifiMgrSetPhase(WIFI_MGR_DISCONNECTING);
+    wifiMgrTrace = wifiMgrTraceStart(wifiMgrFastAttempt ? WIFI_MGR_TRACE_FAST : 0);
+}
+
+// scans while the station stays associated, see wifiMgrSelectBestNetwork()
+void wifiMgrRoam() {
+    if (wifiMgrIsConnecting()) return;
+    wifiMgrRoamScan = true;
+    wifiMgrTrace = wifiMgrTraceStart(WIFI_MGR_TRACE_ROAM);
+    wifiMgrStartScan();
+}
+
+void connectToWifi() {
+    wifiMgrConnect();
+    while (wifiMgrIsConnecting()) {
+        wifiMgrConnectStep();
+        if (loopFunctionPointer != nullptr) loopFunctionPointer();
+        yield();
+    }
+}
+
+WifiMgrConnectPhase wifiMgrGetConnectPhase() {
+    return wifiMgrPhase;
+}
+
+const char* wifiMgrGetConnectPhaseName() {
+    return wifiMgrPhaseNames[wifiMgrPhase];
+}
+
+void wifiMgrSetKeepAP(bool keepAP) {
+    wifiMgrKeepAP = keepAP;
+}
+
+void wifiMgrSetConnectStepBudget(unsigned long budgetMs) {
+    wifiMgrConnectStepBudgetMs = budgetMs;
+}
+
+void wifiMgrSetFastReconnect(bool enabled, bool persist) {
+    wifiMgrFastReconnect = enabled;
+    wifiMgrFastReconnectPersist = persist;
+    wifiMgrFastCacheLoaded = false;
+}
+
+bool wifiMgrAddNetwork(const char* SSID, const char* password) {
+    if (SSID == nullptr || strlen(SSID) == 0 || wifiMgrNetworkCount >= WIFI_MGR_MAX_NETWORKS - 1) return false;
+    WifiMgrNetwork* network = &wifiMgrNetworks[wifiMgrNetworkCount];
+    network->ssid = strdup(SSID);
+    network->password = (password != nullptr && strlen(password) > 0) ? strdup(password) : nullptr;
+    if (network->ssid == nullptr) return false;
+    wifiMgrNetworkCount++;
+    return true;
+}
+
+void wifiMgrClearNetworks() {
+    for (uint8_t i = 0; i < wifiMgrNetworkCount; i++) {
+        free(wifiMgrNetworks[i].ssid);
+        free(wifiMgrNetworks[i].password);
+        wifiMgrNetworks[i].ssid = nullptr;
+        wifiMgrNetworks[i].password = nullptr;
+    }
+    wifiMgrNetworkCount = 0;
+    wifiMgrNetworkIndex = 0;
+}
+
+// reads the additional networks SSID_2 / WIFI_PW_2 ... from the config store
+void wifiMgrLoadNetworksFromConfig() {
+    wifiMgrClearNetworks();
+    char ssidKey[12];
+    char pwKey[12];
+    for (uint8_t i = 2; i <= WIFI_MGR_MAX_NETWORKS; i++) {
+        snprintf(ssidKey, sizeof(ssidKey), "SSID_%u", i);
+        snprintf(pwKey, sizeof(pwKey), "WIFI_PW_%u", i);
+        wifiMgrAddNetwork(wifiMgrGetConfig(ssidKey), wifiMgrGetConfig(pwKey));
+    }
+}
+
+void wifiMgrSetStaticIP(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns) {
+    wifiMgrStaticIP = ip;
+    wifiMgrStaticGateway = gateway;
+    wifiMgrStaticSubnet = subnet;
+    wifiMgrStaticDNS = dns;
+}
+
+void wifiMgrSetReuseLease(bool enabled) {
+    wifiMgrReuseLease = enabled;
+}
+
+void wifiMgrSetBackoff(unsigned long retryBaseMs, unsigned long retryMaxMs, unsigned long blacklistBaseMs, unsigned long blacklistMaxMs) {
+    wifiMgrRetryBaseMs = retryBaseMs;
+    wifiMgrRetryMaxMs = retryMaxMs;
+    wifiMgrBlacklistBaseMs = blacklistBaseMs;
+    wifiMgrBlacklistMaxMs = blacklistMaxMs;
+}
+
+void wifiMgrSetScanPolicy(WifiMgrScanPolicy scanPolicy) {
+    wifiMgrScanPolicy = scanPolicy;
+}
+
+void wifiMgrSetRoaming(bool enabled, uint8_t hysteresisDb) {
+    wifiMgrRoaming = enabled;
+    wifiMgrRoamHysteresis = hysteresisDb;
+}
+
 void setupWifi(const char* SSID, const char* password) {
     setupWifi(SSID, password, nullptr);
 }
@@ -182,6 +902,11 @@ void setupWifi(const char* SSID, const char* password, const char* hostname) {
     setupWifi(SSID, password, hostname, wifiMgrTolerateBadRSSms, wifiMgrWaitForConnectMs);
 }
 
+void setupWifi(const char* SSID, const char* password, const char* hostname, IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns) {
+    wifiMgrSetStaticIP(ip, gateway, subnet, dns);
+    setupWifi(SSID, password, hostname);
+}
+
 void setupWifi(const char* SSID, const char* password, const char* hostname, unsigned long tolerateBadRSSms, unsigned long waitForConnectMs) {
     setupWifi(SSID, password, hostname, tolerateBadRSSms, waitForConnectMs, wifiMgrWaitForScanMs, wifiMgrRescanInterval);
 }
@@ -198,7 +923,11 @@ void onOTAEnd(bool success) {
 }
 
 void setupWifi(const char* SSID, const char* password, const char* hostname, unsigned long tolerateBadRSSms, unsigned long waitForConnectMs, unsigned long waitForScanMs, unsigned long rescanInterval) {
-    WiFi.mode(WIFI_STA);
+    setupWifi(SSID, password, hostname, tolerateBadRSSms, waitForConnectMs, waitForScanMs, rescanInterval, wifiMgrScanPolicy);
+}
+
+void wifiMgrConfigureWifi(const char* SSID, const char* password, const char* hostname, unsigned long tolerateBadRSSms, unsigned long waitForConnectMs, unsigned long waitForScanMs, unsigned long rescanInterval, WifiMgrScanPolicy scanPolicy) {
+    WiFi.mode(wifiMgrStationMode());
     if (hostname != nullptr) WiFi.hostname(hostname);
     WiFi.setAutoConnect(false);
     WiFi.setAutoReconnect(false);
@@ -233,69 +962,172 @@ void setupWifi(const char* SSID, const char* password, const char* hostname, uns
     wifiMgrWaitForConnectMs = waitForConnectMs;
     wifiMgrWaitForScanMs = waitForScanMs;
     wifiMgrRescanInterval = rescanInterval;
+    wifiMgrScanPolicy = scanPolicy;
+
+    wifiMgrRegisterEvents();
+}
 
+void setupWifi(const char* SSID, const char* password, const char* hostname, unsigned long tolerateBadRSSms, unsigned long waitForConnectMs, unsigned long waitForScanMs, unsigned long rescanInterval, WifiMgrScanPolicy scanPolicy) {
+    wifiMgrConfigureWifi(SSID, password, hostname, tolerateBadRSSms, waitForConnectMs, waitForScanMs, rescanInterval, scanPolicy);
     connectToWifi();
 }
 
+void wifiMgrBeginWifi(const char* SSID, const char* password, const char* hostname) {
+    wifiMgrConfigureWifi(SSID, password, hostname, wifiMgrTolerateBadRSSms, wifiMgrWaitForConnectMs, wifiMgrWaitForScanMs, wifiMgrRescanInterval, wifiMgrScanPolicy);
+    if (wifiMgrIsConnecting()) {
+        // an attempt with the old credentials is still running, drop it
+        wifiMgrTraceEnd(WIFI_MGR_TRACE_FAILED);
+        wifiMgrSetPhase(WIFI_MGR_IDLE);
+    }
+    wifiMgrConnect();
+}
+
 void loopWifi() {
-    if (!WiFi.isConnected()) {
-        if (wifiMgrLastScan == 0 || (millis() - wifiMgrLastScan) > 10000) {
-            connectToWifi();
+    wifiMgrEventsLoop();
+#if defined(WIFI_MGR_CONFIG_JOURNAL)
+    wifiMgrJournalLoop();
+#endif
+    bool changed = wifiMgrSyncLinkState();
+    bool associated = wifiMgrLinkAssociated;
+    if (changed) {
+        if (!associated && wifiMgrPhase == WIFI_MGR_CONNECTED) wifiMgrSetPhase(WIFI_MGR_IDLE);
+        // keep the cached lease in sync after a DHCP renewal
+        if (associated && wifiMgrPhase == WIFI_MGR_CONNECTED && !wifiMgrLeaseReused && wifiMgrLinkIP != 0 && wifiMgrFastReconnect) wifiMgrStoreFastCache();
+    }
+
+    if (wifiMgrIsConnecting()) {
+        wifiMgrRunConnectSteps();
+    } else if (!associated) {
+        if (wifiMgrPhase == WIFI_MGR_CONNECTED) wifiMgrSetPhase(WIFI_MGR_IDLE);
+        if (wifiMgrLastScan == 0 || (millis() - wifiMgrLastScan) > wifiMgrRetryDelayMs) {
+            wifiMgrConnect();
         }
-        if (!WiFi.isConnected() && wifiMgrNotifyNoWifiCallback != nullptr && (wifiMgrlastConnected == 0 ? millis() : millis() - wifiMgrlastConnected) > wifiMgrNotifyNoWifiTimeout) {
-            wifiMgrNotifyNoWifiCallback();
+    } else if (millis() - wifiMgrlastConnected > 1000) {
+        wifiMgrlastConnected = millis();
+
+        // catch up in case an event got lost
+        if (!WiFi.isConnected()) wifiMgrSetLinkState(false, 0);
+
+        // the reused lease got us online quickly, now confirm it with the DHCP server in the background
+        if (wifiMgrLeaseReused && (millis() - wifiMgrPhaseSince) > wifiMgrLeaseConfirmDelayMs) {
+            wifiMgrLeaseReused = false;
+            wifiMgrIPConfigured = false;
+            WiFi.config(IPAddress((uint32_t) 0), IPAddress((uint32_t) 0), IPAddress((uint32_t) 0));
         }
-    }
-    if (WiFi.isConnected()) {
-        if (millis() - wifiMgrlastConnected > 1000) {
-            wifiMgrlastConnected = millis();
 
-            int8_t rss = WiFi.RSSI();
+        int8_t rss = WiFi.RSSI();
 
-            if (rss < badRSS) {
-                wifiMgrInvalidRSSISince = 0;
-                if ((millis() - wifiMgrLastNonShitRSS) > wifiMgrTolerateBadRSSms) {
-                    connectToWifi();
+        if (rss > 0) {
+            if (wifiMgrInvalidRSSISince == 0) {
+                wifiMgrInvalidRSSISince = millis();
+            } else {
+                if (millis() - wifiMgrInvalidRSSISince > wifiMgrInvalidRSSITimeout) {
+                    wifiMgrInvalidRSSICount++;
+                    wifiMgrConnect();
                 }
-            } else if (rss > 0) {
-                if (wifiMgrInvalidRSSISince == 0) {
-                    wifiMgrInvalidRSSISince = millis();
-                } else {
-                    if (millis() - wifiMgrInvalidRSSISince > wifiMgrInvalidRSSITimeout) {
-                        wifiMgrInvalidRSSICount++;
-                        connectToWifi();
-                    }
+            }
+        } else {
+            wifiMgrInvalidRSSISince = 0;
+            wifiMgrStatsAddRssi(rss);
+            // a single noisy sample should not count as bad reception
+            if (wifiMgrStatsSmoothedRssi() < badRSS) {
+                if ((millis() - wifiMgrLastNonShitRSS) > wifiMgrTolerateBadRSSms) {
+                    wifiMgrConnect();
                 }
             } else {
-                wifiMgrInvalidRSSISince = 0;
                 wifiMgrLastNonShitRSS = millis();
             }
-            if (WiFi.localIP().toString() == "0.0.0.0") {
-                if (wifiMgrInvalidIPSince == 0) {
-                    wifiMgrInvalidIPSince = millis();
-                } else if (millis() - wifiMgrInvalidIPSince > wifiMgrInvalidIPTimeout) {
-                    wifiMgrInvalidIPCount++;
-                    connectToWifi();
-                }
-            } else {
-                wifiMgrInvalidIPSince = 0;
+        }
+        if (wifiMgrLinkIP == 0) {
+            if (wifiMgrInvalidIPSince == 0) {
+                wifiMgrInvalidIPSince = millis();
+            } else if (millis() - wifiMgrInvalidIPSince > wifiMgrInvalidIPTimeout) {
+                wifiMgrInvalidIPCount++;
+                wifiMgrConnect();
             }
+        } else {
+            wifiMgrInvalidIPSince = 0;
+        }
 
 #if defined(ESP8266)
-            if (wifiMgrServer != nullptr && wifiMgrServer->getServer().status() == 0) {
-                wifiMgrPostStartedServerCount++;
-                wifiMgrServer->begin();
-            }
+        if (wifiMgrServer != nullptr && wifiMgrServer->getServer().status() == 0) {
+            wifiMgrPostStartedServerCount++;
+            wifiMgrServer->begin();
+        }
 #endif
 
-            if (wifiMgrRescanInterval > 0 && (millis() - wifiMgrLastScan) > wifiMgrRescanInterval) {
-                connectToWifi();
-            }
+        if (wifiMgrRescanInterval > 0 && (millis() - wifiMgrLastScan) > wifiMgrRescanInterval) {
+            if (wifiMgrRoaming) wifiMgrRoam();
+            else wifiMgrConnect();
         }
     }
+    if (!associated && wifiMgrNotifyNoWifiCallback != nullptr && (wifiMgrlastConnected == 0 ? millis() : millis() - wifiMgrlastConnected) > wifiMgrNotifyNoWifiTimeout) {
+        wifiMgrNotifyNoWifiCallback();
+    }
     yield();
 }
 
+void wifiMgrChunkBegin(WifiMgrChunkWriter* writer, XWebServer* server, int code, const char* contentType) {
+    writer->server = server;
+    writer->len = 0;
+    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server->send(code, contentType, "");
+}
+
+void wifiMgrChunkFlush(WifiMgrChunkWriter* writer) {
+    if (writer->len == 0) return;
+    writer->server->sendContent(writer->buffer, writer->len);
+    writer->len = 0;
+}
+
+void wifiMgrChunkWrite(WifiMgrChunkWriter* writer, const char* data, size_t len) {
+    while (len > 0) {
+        size_t n = sizeof(writer->buffer) - writer->len;
+        if (n > len) n = len;
+        memcpy(writer->buffer + writer->len, data, n);
+        writer->len += n;
+        data += n;
+        len -= n;
+        if (writer->len == sizeof(writer->buffer)) wifiMgrChunkFlush(writer);
+    }
+}
+
+void wifiMgrChunkWrite(WifiMgrChunkWriter* writer, const char* str) {
+    wifiMgrChunkWrite(writer, str, strlen(str));
+}
+
+void wifiMgrChunkPrintf(WifiMgrChunkWriter* writer, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t space = sizeof(writer->buffer) - writer->len;
+    int len = vsnprintf(writer->buffer + writer->len, space, format, args);
+    va_end(args);
+    if (len < 0) return;
+    if ((size_t) len >= space) {
+        // did not fit, send what we have and format again into the empty buffer
+        wifiMgrChunkFlush(writer);
+        va_start(args, format);
+        len = vsnprintf(writer->buffer, sizeof(writer->buffer), format, args);
+        va_end(args);
+        if (len < 0) return;
+        if ((size_t) len >= sizeof(writer->buffer)) len = sizeof(writer->buffer) - 1;
+    }
+    writer->len += len;
+}
+
+void wifiMgrChunkEnd(WifiMgrChunkWriter* writer) {
+    wifiMgrChunkFlush(writer);
+    writer->server->sendContent("");
+}
+
+std::function<void(void)> wifiMgrTimed(void (*handler)(void)) {
+    return [handler]() {
+        unsigned long start = micros();
+        handler();
+        wifiMgrStatsObserve(WIFI_MGR_HISTOGRAM_HTTP, micros() - start);
+    };
+}
+
 void sendRSSI() {
     wifiMgrServer->send(200, "text/plain", String(WiFi.RSSI()));
 }
@@ -313,17 +1145,23 @@ void bssid() {
 }
 
 void status() {
-    char buffer[500];
+    char buffer[600];
     int len = 0;
 
     len += snprintf(buffer + len, sizeof(buffer) - len, "ssid: %s\n", WiFi.SSID().c_str());
     len += snprintf(buffer + len, sizeof(buffer) - len, "connected: %d\n", WiFi.isConnected());
+    len += snprintf(buffer + len, sizeof(buffer) - len, "phase: %s\n", wifiMgrPhaseNames[wifiMgrPhase]);
     len += snprintf(buffer + len, sizeof(buffer) - len, "bssid: %s\n", WiFi.BSSIDstr().c_str());
     len += snprintf(buffer + len, sizeof(buffer) - len, "rssi: %d\n", WiFi.RSSI());
     len += snprintf(buffer + len, sizeof(buffer) - len, "uptime: %lus\n", millis()/1000);
     len += snprintf(buffer + len, sizeof(buffer) - len, "last scan: %lus\n", (millis() - wifiMgrLastScan)/1000);
     len += snprintf(buffer + len, sizeof(buffer) - len, "scanned: %lu times\n", wifiMgrScanCount);
-    len += snprintf(buffer + len, sizeof(buffer) - len, "connected: %lu times\n\n", wifiMgrConnectCount);
+    len += snprintf(buffer + len, sizeof(buffer) - len, "connected: %lu times\n", wifiMgrConnectCount);
+    len += snprintf(buffer + len, sizeof(buffer) - len, "roamed: %lu times\n", wifiMgrRoamCount);
+    len += snprintf(buffer + len, sizeof(buffer) - len, "fast connects: %lu\n", wifiMgrFastConnectCount);
+    len += snprintf(buffer + len, sizeof(buffer) - len, "retry delay: %lums\n", wifiMgrRetryDelayMs);
+    len += snprintf(buffer + len, sizeof(buffer) - len, "ip config: %s\n", (uint32_t) wifiMgrStaticIP != 0 ? "static" : (wifiMgrLeaseReused ? "reused lease" : "dhcp"));
+    len += snprintf(buffer + len, sizeof(buffer) - len, "boot connect: %lums (fast path: %d)\n\n", wifiMgrBootConnectMs, wifiMgrBootFastPath);
     len += snprintf(buffer + len, sizeof(buffer) - len, "free heap: %du\n", ESP.getFreeHeap());
     len += snprintf(buffer + len, sizeof(buffer) - len, "reconnects invalid IP: %lu\n", wifiMgrInvalidIPCount);
     len += snprintf(buffer + len, sizeof(buffer) - len, "reconnects invalid RSSI: %lu\n", wifiMgrInvalidRSSICount);
@@ -335,6 +1173,66 @@ void status() {
     wifiMgrServer->send(200, "text/plain", buffer);
 }
 
+void linkQuality() {
+    char buffer[512];
+    wifiMgrStatsFormatLinkQuality(buffer, sizeof(buffer));
+    wifiMgrServer->send(200, "text/plain", buffer);
+}
+
+void trace() {
+    char buffer[200];
+    WifiMgrChunkWriter writer;
+    wifiMgrChunkBegin(&writer, wifiMgrServer, 200, "text/plain");
+    for (uint8_t i = 0; i < WIFI_MGR_TRACE_SIZE; i++) {
+        size_t len = wifiMgrTraceFormat(i, buffer, sizeof(buffer));
+        if (len == 0) break;
+        wifiMgrChunkWrite(&writer, buffer, len);
+    }
+    wifiMgrChunkEnd(&writer);
+}
+
+void metricsCounter(WifiMgrChunkWriter* writer, const char* name, unsigned long value) {
+    wifiMgrChunkPrintf(writer, "# TYPE %s counter\n%s_total %lu\n", name, name, value);
+}
+
+void metricsGauge(WifiMgrChunkWriter* writer, const char* name, long value) {
+    wifiMgrChunkPrintf(writer, "# TYPE %s gauge\n%s %ld\n", name, name, value);
+}
+
+void metrics() {
+    WifiMgrChunkWriter writer;
+    wifiMgrChunkBegin(&writer, wifiMgrServer, 200, "application/openmetrics-text; version=1.0.0; charset=utf-8");
+    metricsCounter(&writer, "wifimgr_scans", wifiMgrScanCount);
+    metricsCounter(&writer, "wifimgr_connects", wifiMgrConnectCount);
+    metricsCounter(&writer, "wifimgr_roams", wifiMgrRoamCount);
+    metricsCounter(&writer, "wifimgr_fast_connects", wifiMgrFastConnectCount);
+    metricsCounter(&writer, "wifimgr_reconnects_invalid_rssi", wifiMgrInvalidRSSICount);
+    metricsCounter(&writer, "wifimgr_reconnects_invalid_ip", wifiMgrInvalidIPCount);
+    metricsCounter(&writer, "wifimgr_server_restarts", wifiMgrPostStartedServerCount);
+    metricsGauge(&writer, "wifimgr_connected", wifiMgrLinkAssociated);
+    metricsGauge(&writer, "wifimgr_phase", wifiMgrPhase);
+    metricsGauge(&writer, "wifimgr_rssi_dbm", WiFi.RSSI());
+    metricsGauge(&writer, "wifimgr_rssi_smoothed_dbm", wifiMgrStatsSmoothedRssi());
+    metricsGauge(&writer, "wifimgr_retry_delay_ms", wifiMgrRetryDelayMs);
+    metricsGauge(&writer, "wifimgr_uptime_seconds", millis() / 1000);
+    metricsGauge(&writer, "wifimgr_heap_free_bytes", ESP.getFreeHeap());
+#if defined(ESP8266)
+    metricsGauge(&writer, "wifimgr_heap_max_block_bytes", ESP.getMaxFreeBlockSize());
+    metricsGauge(&writer, "wifimgr_heap_fragmentation_percent", ESP.getHeapFragmentation());
+#elif defined(ESP32)
+    metricsGauge(&writer, "wifimgr_heap_max_block_bytes", ESP.getMaxAllocHeap());
+#endif
+    char buffer[128];
+    for (uint8_t h = 0; h < WIFI_MGR_HISTOGRAM_COUNT; h++) {
+        size_t len;
+        for (uint8_t line = 0; (len = wifiMgrStatsFormatHistogram((WifiMgrHistogramId) h, line, buffer, sizeof(buffer))) > 0; line++) {
+            wifiMgrChunkWrite(&writer, buffer, len);
+        }
+    }
+    wifiMgrChunkWrite(&writer, "# EOF\n");
+    wifiMgrChunkEnd(&writer);
+}
+
 void restart() {
     wifiMgrServer->send(200, "text/plain", "restarting");
     unsigned long start = millis();
@@ -347,17 +1245,21 @@ void reconnect() {
     wifiMgrServer->send(200, "text/plain", "reconnecting");
     unsigned long start = millis();
     while (millis() - start < 500) yield();
-    connectToWifi();
+    wifiMgrConnect();
 }
 
 void wifiMgrExpose(XWebServer *wifiMgrServer_) {
     wifiMgrServer = wifiMgrServer_;
     if (wifiMgrServer != nullptr) {
-        wifiMgrServer->on("/wifiMgr/rssi", sendRSSI);
-        wifiMgrServer->on("/wifiMgr/isConnected", isConnected);
-        wifiMgrServer->on("/wifiMgr/ssid", ssid);
-        wifiMgrServer->on("/wifiMgr/bssid", bssid);
-        wifiMgrServer->on("/wifiMgr/status", status);
+        wifiMgrServer->on("/wifiMgr/rssi", wifiMgrTimed(sendRSSI));
+        wifiMgrServer->on("/wifiMgr/isConnected", wifiMgrTimed(isConnected));
+        wifiMgrServer->on("/wifiMgr/ssid", wifiMgrTimed(ssid));
+        wifiMgrServer->on("/wifiMgr/bssid", wifiMgrTimed(bssid));
+        wifiMgrServer->on("/wifiMgr/status", wifiMgrTimed(status));
+        wifiMgrServer->on("/wifiMgr/linkquality", wifiMgrTimed(linkQuality));
+        wifiMgrServer->on("/wifiMgr/trace", wifiMgrTimed(trace));
+        wifiMgrServer->on("/wifiMgr/metrics", wifiMgrTimed(metrics));
+        wifiMgrServer->on("/wifiMgr/events", HTTP_GET, []() { wifiMgrEventsSubscribe(wifiMgrServer); });
         wifiMgrServer->on("/wifiMgr/restart", restart);
         wifiMgrServer->on("/wifiMgr/reconnect", reconnect);
 
@@ -479,17 +1381,13 @@ void wifiMgrCleanup() {
         free((void*)wifiMgrHN);
         wifiMgrHN = nullptr;
     }
+    wifiMgrClearNetworks();
+    wifiMgrEventsStop();
     
     // Disconnect WiFi
     WiFi.disconnect(true);
     
     // Free MDNS resources
-#if defined(ESP8266)
-    if (wifiMgrMdns.isRunning()) wifiMgrMdns.end();
-#elif defined(ESP32)
-    if (mdnsInitialized) {
-        mdns_free();
-        mdnsInitialized = false;
-    }
-#endif
+    wifiMgrStopMdns();
+    wifiMgrSetPhase(WIFI_MGR_IDLE);
 }
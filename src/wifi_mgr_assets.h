@@ -0,0 +1,171 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+// generated by tools/build_assets.py from web/, do not edit
+
+#ifndef WIFI_MGR_ASSETS_H
+#define WIFI_MGR_ASSETS_H
+
+#include <Arduino.h>
+
+// web/style.css: 2494 bytes, 1998 minified, 755 gzipped
+#define WIFI_MGR_ASSET_STYLE_CSS_ETAG "d24a6c2b7693fd28"
+const uint8_t wifiMgrAssetStyleCss[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x55, 0x6d, 0x6f, 0x9b, 0x30,
+    0x10, 0xfe, 0x2b, 0x51, 0xab, 0xa9, 0xcd, 0x04, 0x08, 0x08, 0x90, 0xd4, 0x68, 0xd2, 0xaa, 0x4d,
+    0xf9, 0x13, 0xd3, 0x3e, 0x18, 0x30, 0xc1, 0x2a, 0xd8, 0xc8, 0x36, 0x4d, 0x33, 0xe4, 0xff, 0xbe,
+    0x33, 0x2f, 0x09, 0x84, 0xa4, 0xc5, 0x9f, 0xb8, 0xb3, 0xef, 0x9e, 0xe7, 0xee, 0xf1, 0x19, 0x09,
+    0xce, 0x55, 0x6b, 0xdb, 0xb5, 0xa0, 0x15, 0x16, 0x27, 0x3b, 0xe5, 0x25, 0x17, 0xe8, 0xd1, 0xf7,
+    0x5e, 0xa2, 0xfd, 0x26, 0xbe, 0xd8, 0x33, 0x2c, 0xde, 0xd0, 0xa3, 0xf7, 0xb2, 0x8d, 0x7e, 0xfb,
+    0x60, 0x96, 0x24, 0xe5, 0x2c, 0x9b, 0x1c, 0xd8, 0xef, 0x5f, 0x76, 0xae, 0x0b, 0x1e, 0x45, 0x3e,
+    0xd4, 0x68, 0xdc, 0x74, 0x1f, 0x18, 0x4b, 0x7a, 0x28, 0x94, 0x9d, 0x1c, 0xd0, 0x63, 0x1e, 0x9a,
+    0x05, 0xa6, 0x84, 0x8b, 0x8c, 0x88, 0x71, 0x67, 0xd6, 0x7d, 0x26, 0x70, 0x93, 0xa6, 0x44, 0xca,
+    0xd1, 0x1e, 0xfc, 0x7a, 0xdd, 0x87, 0x26, 0x2c, 0x11, 0x82, 0x9f, 0x77, 0xef, 0x83, 0x60, 0xb3,
+    0x89, 0xf4, 0xf7, 0x36, 0xe1, 0x1f, 0xb6, 0xa4, 0xff, 0x28, 0x3b, 0xa0, 0x21, 0x1e, 0x58, 0x62,
+    0x00, 0x7c, 0xa0, 0x0c, 0xb9, 0x71, 0x8d, 0xb3, 0xcc, 0xf8, 0x5c, 0x9d, 0xf0, 0xec, 0xd4, 0xe6,
+    0x9c, 0x29, 0x3b, 0xc7, 0x15, 0x2d, 0x4f, 0xe8, 0xe9, 0x55, 0x50, 0x5c, 0x3e, 0x59, 0x12, 0x33,
+    0x09, 0x6c, 0x04, 0xcd, 0xe3, 0x92, 0x32, 0x62, 0x17, 0xc4, 0x40, 0x45, 0x9e, 0x13, 0xc5, 0x7d,
+    0xb2, 0x77, 0x2c, 0x9e, 0xa7, 0xac, 0xd6, 0x71, 0x82, 0xd3, 0xb7, 0x83, 0xe0, 0x0d, 0xcb, 0xec,
+    0xe9, 0x96, 0x91, 0xe3, 0xfa, 0x9c, 0xd6, 0x77, 0x6b, 0x03, 0xe6, 0xc3, 0x3e, 0xd2, 0x4c, 0x15,
+    0x08, 0xea, 0x53, 0x5f, 0xc0, 0xad, 0x70, 0xa3, 0xb8, 0x76, 0xa0, 0x8c, 0x0a, 0x43, 0x62, 0xd1,
+    0x2e, 0xc2, 0x1e, 0x0b, 0xaa, 0x48, 0x3c, 0xf0, 0x12, 0x38, 0xa3, 0x8d, 0x44, 0x3b, 0x88, 0xd0,
+    0x91, 0x2e, 0x70, 0xc6, 0x8f, 0x10, 0xc5, 0xaf, 0x3f, 0x56, 0x1e, 0xc4, 0x5d, 0x89, 0x43, 0x82,
+    0x9f, 0x5d, 0xab, 0x5b, 0x8e, 0xb7, 0x00, 0x61, 0x92, 0x42, 0x71, 0x94, 0xe2, 0x55, 0x67, 0xd2,
+    0x85, 0xd7, 0x4e, 0xd1, 0xcf, 0xfa, 0xbf, 0xbe, 0x71, 0x20, 0xee, 0x4a, 0x80, 0x81, 0x25, 0x43,
+    0x29, 0x61, 0x8a, 0x08, 0x5d, 0xf8, 0x37, 0x43, 0x18, 0xa9, 0x8c, 0x11, 0x90, 0x17, 0x02, 0x36,
+    0xb7, 0x87, 0xe8, 0xc6, 0x5d, 0x07, 0xa0, 0x61, 0x04, 0x0a, 0xec, 0x0b, 0x52, 0xc5, 0xe7, 0xae,
+    0x75, 0x79, 0x3c, 0xd8, 0x24, 0x79, 0x49, 0xb3, 0x55, 0x1f, 0x71, 0xaa, 0x91, 0x33, 0xa3, 0x71,
+    0x33, 0x04, 0xd6, 0x4e, 0xce, 0x45, 0x65, 0x9b, 0xaa, 0xd5, 0xed, 0x1c, 0xb2, 0xc9, 0xab, 0x4b,
+    0x9c, 0x90, 0xb2, 0xcd, 0xa8, 0xac, 0x4b, 0x7c, 0x42, 0x49, 0xc9, 0xd3, 0xb7, 0x2b, 0x66, 0xb0,
+    0xab, 0x07, 0x75, 0xec, 0xfb, 0x9e, 0xf0, 0x32, 0xd3, 0x94, 0xd5, 0x8d, 0xfa, 0xa3, 0x4e, 0x35,
+    0xf9, 0xf1, 0x60, 0x58, 0x3f, 0xfc, 0xb5, 0xa6, 0xa6, 0x1a, 0x4b, 0x79, 0x04, 0x64, 0x57, 0x66,
+    0xd6, 0x54, 0x09, 0x11, 0x60, 0x94, 0xa4, 0x24, 0xa9, 0x6a, 0xfb, 0xa6, 0x7b, 0xae, 0xfb, 0xed,
+    0xdc, 0x0b, 0x53, 0x85, 0x81, 0xf2, 0x17, 0x5c, 0xe7, 0x5d, 0x0f, 0x46, 0x94, 0x7d, 0xe9, 0x22,
+    0xa0, 0xb6, 0xc4, 0x88, 0x72, 0x9e, 0x36, 0xf2, 0x0e, 0xd2, 0x1b, 0xce, 0x11, 0xef, 0xe0, 0xea,
+    0x51, 0xf7, 0x3f, 0x2d, 0x6f, 0x94, 0xb9, 0x0d, 0x88, 0x71, 0x76, 0x56, 0xe0, 0x27, 0x6a, 0x99,
+    0x29, 0xd2, 0x2c, 0x7f, 0x14, 0xe4, 0x66, 0x63, 0x79, 0xa1, 0x6b, 0xf9, 0xc1, 0x06, 0x54, 0xe9,
+    0xaf, 0x75, 0xd2, 0x40, 0xd9, 0xd9, 0x0c, 0x87, 0x6c, 0x92, 0x8a, 0x02, 0xfe, 0xf6, 0xce, 0xbd,
+    0xba, 0xca, 0xb5, 0xbc, 0x1b, 0x3d, 0xca, 0x69, 0x8d, 0x57, 0xa6, 0xfb, 0x37, 0x6a, 0x98, 0x36,
+    0x42, 0xc2, 0xe1, 0x9a, 0x53, 0xa3, 0xdf, 0xab, 0x92, 0xc6, 0x73, 0x9d, 0x4c, 0xda, 0x37, 0x48,
+    0x46, 0xf1, 0x7a, 0xb8, 0x09, 0x02, 0x86, 0x06, 0x55, 0x94, 0x33, 0x74, 0x8d, 0x79, 0xe5, 0x3a,
+    0x1b, 0x39, 0xb0, 0x44, 0x05, 0x7f, 0x27, 0xe2, 0x26, 0xd7, 0xde, 0xf5, 0x15, 0xe3, 0xee, 0x22,
+    0x69, 0xa7, 0x82, 0x79, 0x88, 0x0f, 0xa4, 0x9d, 0xa9, 0x68, 0x76, 0xbd, 0x96, 0x54, 0xb5, 0x33,
+    0x0c, 0xd2, 0x65, 0x8e, 0xae, 0x2f, 0xdb, 0xc8, 0xf2, 0xb6, 0xa1, 0xb5, 0x1b, 0x86, 0xc5, 0x1d,
+    0x4d, 0xce, 0x86, 0xf1, 0x7a, 0x36, 0x10, 0xe7, 0x2e, 0xed, 0x74, 0xf3, 0xf9, 0x4e, 0x32, 0x3f,
+    0x08, 0xac, 0x68, 0x6b, 0x85, 0xc1, 0xa7, 0xc9, 0x26, 0x13, 0x7e, 0x9e, 0x6a, 0xea, 0xd0, 0x0e,
+    0x65, 0x39, 0xbf, 0x93, 0x67, 0x26, 0xb6, 0xfb, 0x89, 0x6e, 0x0a, 0xea, 0x96, 0x4b, 0xe7, 0xf0,
+    0x36, 0x42, 0x9b, 0x16, 0x93, 0x6f, 0xa1, 0x88, 0x8b, 0x92, 0x5c, 0x67, 0x67, 0xe6, 0xda, 0xf0,
+    0x50, 0x45, 0x51, 0xa4, 0x7f, 0x56, 0x24, 0xa3, 0x78, 0xf5, 0x7c, 0x79, 0x08, 0x22, 0xf3, 0x10,
+    0xac, 0xdb, 0xee, 0x4d, 0x9a, 0x36, 0x75, 0xfa, 0x1a, 0x9c, 0xed, 0x61, 0x3f, 0xab, 0xa7, 0x93,
+    0x33, 0x84, 0x0c, 0x66, 0xf8, 0x4e, 0x6d, 0x9e, 0xb1, 0xe9, 0xff, 0xe6, 0xce, 0x3d, 0x08, 0xce,
+    0x07, 0x00, 0x00
+};
+
+// web/script.js: 6988 bytes, 5126 minified, 1659 gzipped
+#define WIFI_MGR_ASSET_SCRIPT_JS_ETAG "710e1c22bde0378a"
+const uint8_t wifiMgrAssetScriptJs[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x58, 0x6d, 0x6f, 0xd4, 0x38,
+    0x10, 0xfe, 0xde, 0x5f, 0x61, 0x5e, 0x8e, 0xa4, 0xa2, 0x9b, 0x6e, 0x29, 0x20, 0xf1, 0xd2, 0x9e,
+    0x68, 0x69, 0xd5, 0x4a, 0x14, 0x10, 0xad, 0x38, 0xdd, 0x21, 0x4e, 0x78, 0x13, 0xef, 0xae, 0xaf,
+    0x8e, 0x1d, 0x6c, 0x67, 0xbb, 0x0b, 0xf4, 0xbf, 0xdf, 0x8c, 0xed, 0x64, 0x93, 0x6c, 0xb6, 0x85,
+    0xd3, 0x7d, 0x69, 0x1d, 0xcf, 0x78, 0x5e, 0x9f, 0x19, 0x8f, 0x37, 0x53, 0x69, 0x99, 0x33, 0x69,
+    0x13, 0x9a, 0x65, 0x47, 0x33, 0x58, 0xbc, 0xe1, 0xc6, 0x32, 0xc9, 0x74, 0x1c, 0xbd, 0x7e, 0x77,
+    0x76, 0xa8, 0xa4, 0xc5, 0x3d, 0x45, 0x33, 0x96, 0x45, 0x5b, 0x64, 0x5c, 0xca, 0xd4, 0x72, 0x25,
+    0xe3, 0x4d, 0xf2, 0x7d, 0x23, 0x55, 0xd2, 0x58, 0x32, 0x56, 0x3a, 0x27, 0x7b, 0x24, 0xab, 0xe4,
+    0x7c, 0x2d, 0x99, 0x5e, 0x9c, 0x33, 0xc1, 0x52, 0xab, 0x40, 0x08, 0x92, 0xa3, 0xcd, 0x17, 0x1b,
+    0x7c, 0x4c, 0x62, 0x5c, 0xe3, 0x41, 0xfc, 0xdf, 0xa3, 0xcf, 0x94, 0xa3, 0x9c, 0xdb, 0xa6, 0x16,
+    0xb6, 0x54, 0xe3, 0x89, 0x07, 0x56, 0x82, 0x2e, 0x77, 0xbe, 0xa3, 0x87, 0xcb, 0xa2, 0xb4, 0x9f,
+    0xec, 0xa2, 0x60, 0x7b, 0x77, 0x3d, 0xef, 0xdd, 0xcf, 0x95, 0xde, 0xfa, 0xec, 0x52, 0x9c, 0xd2,
+    0x7c, 0xc2, 0x25, 0x15, 0x17, 0x6c, 0x6e, 0x41, 0x62, 0xcd, 0x91, 0xcc, 0xa8, 0x28, 0x19, 0xf9,
+    0xf1, 0x83, 0x44, 0xe7, 0xde, 0x9c, 0x17, 0x1b, 0x5d, 0xe2, 0x1e, 0xd0, 0xe8, 0x8c, 0xcb, 0x49,
+    0x92, 0x24, 0x2d, 0x72, 0xc6, 0x0d, 0x1d, 0x09, 0x96, 0x01, 0x87, 0xd5, 0x25, 0x03, 0x12, 0xb3,
+    0x17, 0x3c, 0x67, 0xaa, 0xb4, 0x31, 0x44, 0x6c, 0x6f, 0x1f, 0xd4, 0xaf, 0x0a, 0x6b, 0x9a, 0xb2,
+    0x46, 0xda, 0x98, 0x0a, 0x03, 0xe2, 0xae, 0xb7, 0xc8, 0x93, 0xe1, 0x70, 0x08, 0x5e, 0x5d, 0x6f,
+    0x5c, 0xbb, 0xbf, 0xde, 0x99, 0x82, 0x1a, 0x73, 0xa5, 0x74, 0x76, 0x8a, 0x31, 0x30, 0x6b, 0x93,
+    0xf1, 0x4a, 0x88, 0x76, 0x9c, 0xaa, 0x73, 0x3e, 0x52, 0x6d, 0x29, 0x09, 0x04, 0xf9, 0x88, 0xa6,
+    0xd3, 0xd8, 0x1d, 0xf0, 0xb6, 0x7b, 0x6d, 0x56, 0x4d, 0x26, 0x82, 0xf9, 0x4c, 0xd4, 0x8a, 0x52,
+    0xcd, 0xa8, 0x65, 0x47, 0x82, 0xe1, 0x57, 0x1c, 0x8d, 0x4a, 0x6b, 0x95, 0x44, 0xa9, 0x35, 0x77,
+    0x82, 0x3a, 0x31, 0x76, 0x81, 0xd6, 0x24, 0xa5, 0x02, 0x74, 0xbf, 0xa5, 0xb9, 0xa3, 0x57, 0x76,
+    0x0c, 0x3c, 0xbd, 0xc5, 0x68, 0x21, 0x46, 0x01, 0x93, 0x2e, 0x0d, 0x53, 0x75, 0xd5, 0xa2, 0x1b,
+    0xbb, 0x10, 0x2c, 0x29, 0x94, 0xe1, 0x88, 0x1f, 0x64, 0xa1, 0x23, 0xa3, 0x44, 0x69, 0x59, 0x0f,
+    0x1b, 0xc4, 0x7d, 0xea, 0xc4, 0xec, 0x0c, 0x8b, 0x79, 0x0f, 0xdd, 0xaa, 0x02, 0xa9, 0x4f, 0x86,
+    0xbf, 0xf5, 0x11, 0x35, 0x95, 0x26, 0x60, 0x3f, 0x72, 0x1f, 0x02, 0x02, 0xf0, 0x67, 0x3c, 0x00,
+    0xf6, 0xcd, 0x1e, 0xfe, 0x11, 0x4d, 0x2f, 0x27, 0x5a, 0x95, 0x12, 0xf3, 0x19, 0x49, 0x25, 0xfb,
+    0x2c, 0x1a, 0x81, 0xdb, 0x4c, 0xdf, 0xc0, 0x90, 0x2a, 0xa1, 0x1c, 0xfd, 0xde, 0xa3, 0x9d, 0x67,
+    0x4f, 0x8f, 0x77, 0xfb, 0x58, 0x4a, 0x6d, 0x3c, 0x4f, 0xa1, 0x38, 0x44, 0x4a, 0xf7, 0xf0, 0x8c,
+    0x21, 0x84, 0xe7, 0xfc, 0x9b, 0x0b, 0xf7, 0xce, 0x63, 0xe7, 0xbc, 0xcf, 0xed, 0x95, 0xa6, 0x45,
+    0xe1, 0x2c, 0x58, 0x97, 0xd9, 0x8c, 0xcf, 0x30, 0xad, 0x81, 0xb1, 0x27, 0xe0, 0x9a, 0x41, 0x20,
+    0xf8, 0x0c, 0xad, 0x77, 0xd0, 0x49, 0x0a, 0xaa, 0xe1, 0xe4, 0x5b, 0x95, 0xb1, 0x84, 0x4b, 0xc3,
+    0xb4, 0x3d, 0x60, 0x10, 0x37, 0x16, 0x07, 0x11, 0x5b, 0xc4, 0xb1, 0x35, 0x64, 0xe2, 0x5f, 0x99,
+    0x1d, 0x4e, 0xb9, 0xc8, 0xe2, 0x9b, 0x68, 0xb5, 0x57, 0x2d, 0x98, 0xad, 0xf6, 0x95, 0x54, 0xf0,
+    0xf4, 0xb2, 0xdb, 0xbc, 0xb0, 0x2f, 0x78, 0xfb, 0x3c, 0x2e, 0xf7, 0x1a, 0xc8, 0x8b, 0x1c, 0x43,
+    0x83, 0x08, 0x19, 0x06, 0xe0, 0xdd, 0x84, 0xc4, 0x13, 0x9e, 0xa1, 0xc7, 0xd7, 0x84, 0x41, 0xa5,
+    0xae, 0x9c, 0xae, 0x05, 0xdf, 0x8e, 0xe5, 0x50, 0xd9, 0x9b, 0x55, 0x46, 0xf8, 0x2f, 0xd6, 0x34,
+    0x4a, 0xbd, 0xfb, 0x39, 0x04, 0x75, 0xa5, 0xce, 0xdb, 0xfb, 0xb2, 0xcc, 0x47, 0x4c, 0x87, 0x3e,
+    0xb9, 0xb6, 0xea, 0xbd, 0x2b, 0xab, 0x61, 0x1d, 0x89, 0x52, 0x77, 0xa3, 0x0a, 0x3d, 0x8d, 0x67,
+    0x00, 0x17, 0xd7, 0x43, 0xea, 0xe4, 0xb5, 0x3d, 0x92, 0xcc, 0x82, 0x31, 0x97, 0x28, 0xa8, 0xe9,
+    0xd6, 0x84, 0xd9, 0x00, 0xb2, 0x83, 0xc5, 0x69, 0x16, 0x47, 0x57, 0x7c, 0xcc, 0xcf, 0x26, 0xfa,
+    0xad, 0xe7, 0x36, 0x55, 0x2f, 0x6f, 0x9c, 0x46, 0x85, 0x02, 0x6e, 0xa6, 0x8a, 0xa5, 0x45, 0x5b,
+    0x76, 0x47, 0x80, 0x8c, 0x58, 0x9c, 0x5b, 0x6a, 0x4b, 0x73, 0x93, 0x3e, 0xc7, 0x36, 0x30, 0x8e,
+    0xaf, 0x52, 0xd6, 0x38, 0x8a, 0xca, 0x0a, 0x25, 0xc4, 0xab, 0xe5, 0x56, 0x8b, 0xbc, 0xd4, 0x97,
+    0x33, 0x63, 0xe8, 0x84, 0xdd, 0x92, 0xb3, 0x24, 0xb0, 0x3d, 0x97, 0xca, 0xc6, 0xf7, 0x9a, 0xca,
+    0x37, 0x2b, 0xed, 0x95, 0xa0, 0x44, 0x30, 0x39, 0xb1, 0x53, 0xb2, 0x4f, 0x86, 0x68, 0x45, 0xcf,
+    0xa5, 0x52, 0x73, 0x56, 0xe9, 0xcb, 0xcd, 0x24, 0x50, 0xcc, 0x24, 0xd4, 0xa8, 0x2a, 0x68, 0xca,
+    0xed, 0x02, 0xa1, 0x36, 0x04, 0x9c, 0x2d, 0x09, 0xae, 0x79, 0xd5, 0xe5, 0x5b, 0xb1, 0x0d, 0x93,
+    0x27, 0x86, 0x30, 0x6a, 0x10, 0xd5, 0x7d, 0x1a, 0xeb, 0xe3, 0x70, 0x4d, 0x15, 0x82, 0x2e, 0x1a,
+    0x4d, 0xcb, 0x5f, 0x53, 0x55, 0xde, 0x3b, 0x77, 0x56, 0x05, 0x17, 0xd2, 0xca, 0x9c, 0x08, 0xe9,
+    0x1c, 0x33, 0x0b, 0xd6, 0x47, 0xdb, 0x21, 0xf9, 0xdb, 0xb4, 0xe0, 0xdb, 0xb2, 0x46, 0xc0, 0x46,
+    0x62, 0xa7, 0x4c, 0xc6, 0x9a, 0x99, 0x02, 0x22, 0xcd, 0xd0, 0x92, 0x6a, 0x9d, 0xfc, 0x63, 0x10,
+    0x82, 0x0d, 0x96, 0x52, 0x04, 0xfc, 0xa2, 0x6c, 0xe8, 0x3c, 0x80, 0xd9, 0x93, 0x8b, 0xb3, 0x37,
+    0x68, 0x27, 0xd8, 0xe8, 0x19, 0x92, 0x4a, 0x76, 0x1d, 0xb8, 0xb0, 0xd1, 0xbc, 0xef, 0x54, 0x11,
+    0x62, 0xb3, 0xae, 0x25, 0x7a, 0x06, 0xcc, 0x9a, 0x5f, 0xd5, 0x37, 0x7b, 0x10, 0x96, 0x18, 0xc3,
+    0xb3, 0x9a, 0x28, 0xe8, 0x88, 0x89, 0x06, 0x51, 0x03, 0x95, 0x3c, 0x24, 0x11, 0xc9, 0x0e, 0xf2,
+    0x08, 0x16, 0x95, 0x09, 0x90, 0x30, 0x26, 0xc9, 0xef, 0x04, 0x4a, 0x0c, 0x57, 0x11, 0x79, 0x0e,
+    0x86, 0x83, 0x0e, 0xe7, 0x4e, 0xb3, 0x0d, 0x7a, 0xb9, 0x21, 0xdc, 0x88, 0x9b, 0xe0, 0x1b, 0x00,
+    0x82, 0xbc, 0x24, 0x43, 0x9c, 0x65, 0xc2, 0x8e, 0x49, 0xa9, 0x94, 0x30, 0xb7, 0xf4, 0xa2, 0x68,
+    0x35, 0x1f, 0x5b, 0x64, 0x77, 0x99, 0xb9, 0x8d, 0x24, 0xa5, 0x98, 0x9b, 0x00, 0x00, 0x3f, 0x7e,
+    0xd4, 0xc9, 0xec, 0x56, 0x06, 0xf3, 0xb1, 0x59, 0x97, 0xd2, 0x76, 0xad, 0xfd, 0x7c, 0x5a, 0x4d,
+    0xa8, 0xe2, 0xfd, 0xd0, 0xc0, 0xfd, 0x77, 0x82, 0xff, 0xaa, 0x16, 0x0e, 0x61, 0x01, 0x0f, 0x23,
+    0xf4, 0x7a, 0x95, 0x0a, 0x09, 0x95, 0x50, 0x82, 0x37, 0x31, 0xe4, 0x30, 0x7d, 0x39, 0x06, 0xb4,
+    0x3d, 0xb8, 0xd1, 0x6d, 0xd5, 0xce, 0x53, 0xe0, 0x21, 0x7f, 0xf0, 0x63, 0x4e, 0x20, 0x92, 0x78,
+    0xc0, 0xc0, 0x34, 0x48, 0x62, 0xcc, 0x60, 0x10, 0x5b, 0x4c, 0xa1, 0x7a, 0x30, 0xb3, 0x9b, 0x7d,
+    0x25, 0xb4, 0x2e, 0x62, 0x5b, 0x64, 0x27, 0x04, 0xdd, 0x5f, 0x25, 0xfd, 0x6e, 0x8e, 0x29, 0x87,
+    0xc9, 0xb0, 0x65, 0x63, 0x6b, 0x86, 0x0a, 0x0d, 0x81, 0x30, 0xad, 0x15, 0x0e, 0x00, 0x6b, 0x1c,
+    0x39, 0x76, 0x62, 0x60, 0xa2, 0x23, 0x21, 0x32, 0xb8, 0x44, 0xa7, 0x12, 0xf2, 0x5e, 0x60, 0xf1,
+    0x93, 0x74, 0xca, 0xd2, 0x4b, 0xb2, 0x50, 0xa5, 0x26, 0x80, 0xfa, 0x0c, 0xce, 0x71, 0x98, 0x45,
+    0x93, 0xe6, 0x55, 0x77, 0xa3, 0x01, 0xa6, 0x4c, 0x53, 0x58, 0xae, 0x37, 0xe1, 0xd0, 0x2b, 0xf6,
+    0x56, 0x34, 0xa2, 0x87, 0x35, 0xe3, 0xca, 0xe2, 0x8a, 0x43, 0xeb, 0x3b, 0x7d, 0xdf, 0xa4, 0xf1,
+    0x02, 0xeb, 0x24, 0x7c, 0x00, 0x54, 0x2c, 0xd5, 0xd6, 0x57, 0x0a, 0xa0, 0x84, 0x64, 0x6c, 0xc6,
+    0x53, 0x46, 0xc2, 0xbe, 0x21, 0x52, 0x5d, 0x25, 0xae, 0x7a, 0x92, 0xfa, 0x3d, 0xe0, 0x4f, 0xfa,
+    0x64, 0xfb, 0x18, 0xac, 0xcb, 0xf6, 0x43, 0x30, 0x91, 0x2c, 0xc3, 0x64, 0xe8, 0x8c, 0xd5, 0x09,
+    0xc7, 0x8d, 0xa3, 0xa3, 0xf7, 0x1f, 0xde, 0x9d, 0x25, 0xfe, 0xe2, 0x5e, 0x2d, 0x93, 0x5f, 0xc9,
+    0xfb, 0xa3, 0xe1, 0xb2, 0x69, 0x2e, 0x2b, 0xab, 0xef, 0x46, 0xad, 0x5b, 0x13, 0x9b, 0x43, 0x9d,
+    0x82, 0x29, 0x47, 0x98, 0x66, 0x88, 0xe6, 0xca, 0xc0, 0xd5, 0x79, 0x24, 0x25, 0x41, 0x1a, 0x08,
+    0x1e, 0x78, 0x68, 0x84, 0x88, 0xb4, 0x04, 0xb9, 0x58, 0x34, 0x37, 0x20, 0xc6, 0xb9, 0x9a, 0xb1,
+    0xd8, 0x59, 0x86, 0xec, 0x77, 0xbc, 0x22, 0xdf, 0xe7, 0x1e, 0x3c, 0x20, 0xe1, 0x1b, 0x00, 0xff,
+    0xca, 0x5a, 0xcd, 0x61, 0xc2, 0x67, 0x31, 0x0c, 0x82, 0x5f, 0x4b, 0xae, 0x11, 0xa5, 0x28, 0x50,
+    0x33, 0x5b, 0x6a, 0x19, 0xde, 0x45, 0xd7, 0x1b, 0x82, 0xc1, 0x68, 0x63, 0x3e, 0xa2, 0x39, 0xf5,
+    0x6b, 0x09, 0xf7, 0x9c, 0x55, 0x67, 0x01, 0x3c, 0xbe, 0x55, 0x2f, 0x27, 0x35, 0xe9, 0xc0, 0x85,
+    0xf8, 0x3f, 0x3f, 0x3f, 0x7d, 0x1d, 0xa1, 0xe6, 0x86, 0x21, 0xd5, 0x35, 0xf9, 0x92, 0xec, 0xb8,
+    0xf9, 0xad, 0x96, 0x1e, 0x5e, 0x4f, 0x5d, 0xd1, 0x28, 0x03, 0x6c, 0x20, 0xb5, 0x9d, 0xad, 0x9a,
+    0xeb, 0x6a, 0x3c, 0x79, 0x77, 0x7e, 0xb1, 0x4e, 0x63, 0xb8, 0x98, 0x7d, 0x4e, 0xa6, 0xca, 0x58,
+    0x3c, 0xf6, 0x81, 0x4d, 0xd8, 0x1c, 0xf4, 0x6c, 0xff, 0xfd, 0x89, 0x0e, 0xbe, 0xbd, 0x1a, 0xfc,
+    0x35, 0x1c, 0x3c, 0x1b, 0x7c, 0x7e, 0x78, 0x7f, 0xdb, 0x7b, 0x74, 0xa7, 0xc5, 0x07, 0x98, 0x33,
+    0x21, 0xbb, 0x5e, 0xf4, 0xe6, 0x4f, 0xb9, 0x70, 0x12, 0x64, 0x10, 0x68, 0xec, 0x44, 0x49, 0xb1,
+    0xc0, 0x3a, 0xb6, 0x94, 0xc3, 0xed, 0x0a, 0x18, 0x65, 0xda, 0x6c, 0x11, 0x3f, 0xe3, 0xc1, 0x82,
+    0xc2, 0xcb, 0x63, 0xba, 0x28, 0xa0, 0x8d, 0x1a, 0x8f, 0xd6, 0xae, 0xaf, 0xcb, 0x39, 0xd8, 0x9f,
+    0x89, 0x96, 0x3e, 0xe5, 0x5c, 0xd6, 0xe8, 0x82, 0xb9, 0xa9, 0x91, 0x64, 0xa0, 0x44, 0xf5, 0x64,
+    0x97, 0xd3, 0xf9, 0x3a, 0x36, 0x3a, 0xaf, 0xa7, 0x1a, 0x90, 0x75, 0x07, 0xb4, 0xc8, 0x52, 0x08,
+    0x8c, 0x27, 0xa0, 0xd5, 0x00, 0xba, 0xdb, 0xde, 0x43, 0x12, 0xeb, 0x7d, 0x38, 0xf0, 0x53, 0xd1,
+    0xf8, 0xf2, 0xd1, 0xc1, 0x31, 0x2f, 0xc1, 0x92, 0x11, 0x23, 0xd4, 0x12, 0x6c, 0x61, 0x96, 0xdc,
+    0xff, 0x0e, 0x12, 0xae, 0xbf, 0xb4, 0xb2, 0x8b, 0x96, 0xde, 0x6e, 0xc4, 0x7e, 0xc3, 0x08, 0x3a,
+    0xff, 0x8f, 0x46, 0xe4, 0xca, 0xdb, 0x40, 0xe7, 0xce, 0x86, 0xba, 0x82, 0xbc, 0xa0, 0x46, 0x2d,
+    0xa3, 0xa0, 0x30, 0x53, 0xdc, 0xfe, 0xfe, 0x6a, 0x72, 0xb7, 0x3b, 0xef, 0x4a, 0x89, 0x77, 0x98,
+    0xbb, 0x0f, 0xc9, 0xe3, 0xc7, 0x8f, 0x77, 0x77, 0x9f, 0xf6, 0x73, 0xb5, 0xde, 0x89, 0x8f, 0xdc,
+    0x3b, 0xb1, 0x87, 0x2b, 0xa7, 0x7a, 0xc2, 0xe5, 0x45, 0x78, 0x2d, 0xaf, 0x72, 0xb5, 0x3b, 0x7e,
+    0x33, 0x60, 0x3d, 0x4f, 0xc4, 0xe6, 0x64, 0xd3, 0x94, 0x52, 0x3d, 0x51, 0x5a, 0x2f, 0xe5, 0xc3,
+    0x55, 0x2f, 0x3a, 0x2f, 0xb0, 0x5e, 0x6e, 0x87, 0xff, 0xd0, 0x90, 0x42, 0x1e, 0x7a, 0x7b, 0xee,
+    0x31, 0x3c, 0xef, 0xeb, 0x1f, 0xad, 0x3a, 0xcf, 0xb1, 0xd5, 0xdf, 0xa0, 0xfe, 0xb7, 0xa7, 0x58,
+    0x5f, 0x6f, 0xbc, 0xe1, 0x79, 0x86, 0x68, 0xea, 0xbb, 0x25, 0x7a, 0xe1, 0xea, 0x87, 0xf0, 0x15,
+    0xdf, 0xff, 0x05, 0xca, 0xbb, 0xd3, 0x28, 0x06, 0x14, 0x00, 0x00
+};
+
+#endif //WIFI_MGR_ASSETS_H
@@ -0,0 +1,108 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#include "wifi_mgr_dns.h"
+#include <WiFiUdp.h>
+
+#define WIFI_MGR_DNS_PORT 53
+#define WIFI_MGR_DNS_HEADER_SIZE 12
+// queries handled per wifiMgrDnsLoop() call, keeps the web server responsive under a burst
+#define WIFI_MGR_DNS_MAX_PER_LOOP 4
+
+#define WIFI_MGR_DNS_TYPE_A 1
+#define WIFI_MGR_DNS_TYPE_ANY 255
+#define WIFI_MGR_DNS_CLASS_IN 1
+#define WIFI_MGR_DNS_RCODE_FORMERR 1
+#define WIFI_MGR_DNS_RCODE_NOTIMP 4
+
+WiFiUDP wifiMgrDnsUdp;
+bool wifiMgrDnsRunning = false;
+uint8_t wifiMgrDnsIP[4];
+uint8_t wifiMgrDnsBuffer[WIFI_MGR_DNS_BUFFER_SIZE];
+
+uint16_t wifiMgrDnsRead16(const uint8_t* p) {
+    return (p[0] << 8) | p[1];
+}
+
+void wifiMgrDnsWrite16(uint8_t* p, uint16_t value) {
+    p[0] = value >> 8;
+    p[1] = value & 0xFF;
+}
+
+// header only response with an error code, the question is dropped
+size_t wifiMgrDnsError(uint8_t* packet, uint8_t rcode) {
+    packet[2] = 0x80 | (packet[2] & 0x79); // QR, keep opcode and RD
+    packet[3] = rcode;
+    memset(packet + 4, 0, 8);
+    return WIFI_MGR_DNS_HEADER_SIZE;
+}
+
+size_t wifiMgrDnsAnswer(uint8_t* packet, size_t len, size_t size, const uint8_t ip[4]) {
+    if (len < WIFI_MGR_DNS_HEADER_SIZE) return 0;
+    // responses are never answered
+    if (packet[2] & 0x80) return 0;
+    if (((packet[2] >> 3) & 0x0F) != 0) return wifiMgrDnsError(packet, WIFI_MGR_DNS_RCODE_NOTIMP);
+    if (wifiMgrDnsRead16(packet + 4) != 1) return wifiMgrDnsError(packet, WIFI_MGR_DNS_RCODE_FORMERR);
+
+    // walk the name of the only question, compression is not allowed there
+    size_t pos = WIFI_MGR_DNS_HEADER_SIZE;
+    while (true) {
+        if (pos >= len) return wifiMgrDnsError(packet, WIFI_MGR_DNS_RCODE_FORMERR);
+        uint8_t label = packet[pos];
+        if (label == 0) break;
+        if (label > 63) return wifiMgrDnsError(packet, WIFI_MGR_DNS_RCODE_FORMERR);
+        pos += label + 1;
+    }
+    pos++;
+    if (pos + 4 > len) return wifiMgrDnsError(packet, WIFI_MGR_DNS_RCODE_FORMERR);
+    uint16_t type = wifiMgrDnsRead16(packet + pos);
+    uint16_t cls = wifiMgrDnsRead16(packet + pos + 2);
+    pos += 4;
+
+    // anything after the question (EDNS OPT records) is dropped
+    packet[2] = 0x84 | (packet[2] & 0x01); // QR, AA, keep RD
+    packet[3] = 0x80; // RA, NOERROR
+    memset(packet + 6, 0, 6);
+
+    // other types get an empty NOERROR answer, so clients fall back to A quickly
+    if ((type != WIFI_MGR_DNS_TYPE_A && type != WIFI_MGR_DNS_TYPE_ANY) || cls != WIFI_MGR_DNS_CLASS_IN) return pos;
+    if (pos + 16 > size) return wifiMgrDnsError(packet, WIFI_MGR_DNS_RCODE_FORMERR);
+
+    wifiMgrDnsWrite16(packet + 6, 1);
+    uint8_t* answer = packet + pos;
+    wifiMgrDnsWrite16(answer, 0xC000 | WIFI_MGR_DNS_HEADER_SIZE); // pointer to the question name
+    wifiMgrDnsWrite16(answer + 2, WIFI_MGR_DNS_TYPE_A);
+    wifiMgrDnsWrite16(answer + 4, WIFI_MGR_DNS_CLASS_IN);
+    wifiMgrDnsWrite16(answer + 6, 0);
+    wifiMgrDnsWrite16(answer + 8, WIFI_MGR_DNS_TTL);
+    wifiMgrDnsWrite16(answer + 10, 4);
+    memcpy(answer + 12, ip, 4);
+    return pos + 16;
+}
+
+void wifiMgrDnsStart(IPAddress ip) {
+    wifiMgrDnsStop();
+    for (uint8_t i = 0; i < 4; i++) wifiMgrDnsIP[i] = ip[i];
+    wifiMgrDnsRunning = wifiMgrDnsUdp.begin(WIFI_MGR_DNS_PORT) == 1;
+}
+
+void wifiMgrDnsLoop() {
+    if (!wifiMgrDnsRunning) return;
+    for (uint8_t i = 0; i < WIFI_MGR_DNS_MAX_PER_LOOP; i++) {
+        int available = wifiMgrDnsUdp.parsePacket();
+        if (available <= 0) return;
+        // oversized queries are truncated and end up as FORMERR
+        int len = wifiMgrDnsUdp.read(wifiMgrDnsBuffer, sizeof(wifiMgrDnsBuffer));
+        if (len <= 0) continue;
+        size_t responseLen = wifiMgrDnsAnswer(wifiMgrDnsBuffer, len, sizeof(wifiMgrDnsBuffer), wifiMgrDnsIP);
+        if (responseLen == 0) continue;
+        wifiMgrDnsUdp.beginPacket(wifiMgrDnsUdp.remoteIP(), wifiMgrDnsUdp.remotePort());
+        wifiMgrDnsUdp.write(wifiMgrDnsBuffer, responseLen);
+        wifiMgrDnsUdp.endPacket();
+    }
+}
+
+void wifiMgrDnsStop() {
+    if (!wifiMgrDnsRunning) return;
+    wifiMgrDnsUdp.stop();
+    wifiMgrDnsRunning = false;
+}
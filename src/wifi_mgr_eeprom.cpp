@@ -1,207 +1,507 @@
 // PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
 
 #include "wifi_mgr_eeprom.h"
+#if defined(WIFI_MGR_CONFIG_JOURNAL)
+#include "wifi_mgr_journal.h"
+#endif
 
 //  EEPROM SETUP
 // HEADER HEADER VERSION VERSION NR_ENTRIES
 // FOR EACH ENTRY:
-// LENGTH_OF_NAME LENGTH_OF VALUE NAME NAME NAME NAME VALUE VALUE VALUE
+// LENGTH_OF_NAME NAME NAME NAME 0x00 LENGTH_OF_VALUE VALUE VALUE VALUE 0x00
+// Version 0x0001 had no terminators, it is still read and rewritten once.
+// With WIFI_MGR_CONFIG_JOURNAL the config lives in wifi_mgr_journal.cpp instead, this table is
+// only read once to import it.
 
+#ifndef WIFI_MGR_MAX_CONFIG_ENTRIES
 #define WIFI_MGR_MAX_CONFIG_ENTRIES 32
+#endif
+// slots of the lookup index, a power of two and at least twice WIFI_MGR_MAX_CONFIG_ENTRIES
+#ifndef WIFI_MGR_CONFIG_INDEX_SIZE
+#define WIFI_MGR_CONFIG_INDEX_SIZE 64
+#endif
 
 #define WIFI_MGR_EEPROM_HEADER_1 0x43
 #define WIFI_MGR_EEPROM_HEADER_2 0x96
 #define WIFI_MGR_EEPROM_VERSION_1 0x00
-#define WIFI_MGR_EEPROM_VERSION_2 0x01
+#define WIFI_MGR_EEPROM_VERSION_2 0x02
+#define WIFI_MGR_EEPROM_VERSION_2_UNTERMINATED 0x01
+#define WIFI_MGR_EEPROM_HEADER_SIZE 5
+// length bytes and terminators of one entry
+#define WIFI_MGR_EEPROM_ENTRY_OVERHEAD 4
+
+static_assert((WIFI_MGR_CONFIG_INDEX_SIZE & (WIFI_MGR_CONFIG_INDEX_SIZE - 1)) == 0, "index size must be a power of two");
+static_assert(WIFI_MGR_CONFIG_INDEX_SIZE >= 2 * WIFI_MGR_MAX_CONFIG_ENTRIES, "index must stay at most half full");
+static_assert(WIFI_MGR_CONFIG_INDEX_SIZE <= 256, "index positions and slots are stored in one byte");
 
 bool initialized = false;
 int eepromStartAddress = 512;
 int eepromSize = 1024;
 
+// the config area inside the RAM mirror both cores keep after EEPROM.begin()
+const char* mirror = nullptr;
+size_t mirrorSize = 0;
+
 struct CacheEntry {
-    char* name = nullptr;
-    size_t nameLen = 0;
-    char* value = nullptr;
-    size_t valueLen = 0;
+    const char* name = nullptr; // in the mirror until written, then in the arena
+    uint8_t nameLen = 0;
+    const char* value = nullptr;
+    uint8_t valueLen = 0;
+    uint8_t valueCapacity = 0; // without the terminator, a shorter value is overwritten in place
+    uint32_t hash = 0; // wifiMgrConfigHash(name)
+    bool dirty = false; // differs from the committed image
+    uint32_t seq = 0; // of the newest journal record
 };
-CacheEntry* cache = new CacheEntry[WIFI_MGR_MAX_CONFIG_ENTRIES];
+CacheEntry cache[WIFI_MGR_MAX_CONFIG_ENTRIES];
+// entries are only ever appended, so the used ones are cache[0..cacheCount)
+uint8_t cacheCount = 0;
+// open addressing with linear probing, holds the cache slot + 1 or 0 if free.
+// Entries are only removed all at once, so there are no tombstones.
+uint8_t cacheIndex[WIFI_MGR_CONFIG_INDEX_SIZE];
+// the image has to be written from the start, e.g. after reading an old version
+bool rewriteImage = false;
+
+// Written names and values live in one buffer of eepromSize bytes, allocated on the first write.
+// Blocks are taken from the top, a value that outgrew its block leaves a hole that compactArena()
+// reclaims. Everything that fits into the EEPROM area fits into the arena.
+char* arena = nullptr;
+size_t arenaSize = 0;
+size_t arenaUsed = 0;
+
+bool inArena(const char* block) {
+    return arena != nullptr && block >= arena && block < arena + arenaSize;
+}
+
+// slides all live blocks down in address order, tightening value blocks to their length
+void compactArena() {
+    char* top = arena;
+    while (true) {
+        const char** next = nullptr;
+        size_t nextSize = 0;
+        for (int i = 0; i < cacheCount; i++) {
+            CacheEntry* entry = &cache[i];
+            if (inArena(entry->name) && entry->name >= top && (next == nullptr || entry->name < *next)) {
+                next = &entry->name;
+                nextSize = entry->nameLen + 1;
+            }
+            if (inArena(entry->value) && entry->value >= top && (next == nullptr || entry->value < *next)) {
+                next = &entry->value;
+                nextSize = entry->valueLen + 1;
+                entry->valueCapacity = entry->valueLen;
+            }
+        }
+        if (next == nullptr) break;
+        memmove(top, *next, nextSize);
+        *next = top;
+        top += nextSize;
+    }
+    arenaUsed = top - arena;
+}
+
+char* arenaAlloc(size_t size, bool compact = true) {
+    if (arena == nullptr) {
+        arena = new char[eepromSize];
+        if (arena == nullptr) return nullptr;
+        arenaSize = eepromSize;
+        arenaUsed = 0;
+    }
+    if (arenaUsed + size > arenaSize && compact) compactArena();
+    if (arenaUsed + size > arenaSize) return nullptr;
+    char* block = arena + arenaUsed;
+    arenaUsed += size;
+    return block;
+}
+
+// copy on write: moves a name or value out of the mirror
+bool copyToArena(const char** block, uint8_t len) {
+    char* copy = arenaAlloc(len + 1);
+    if (copy == nullptr) return false;
+    memcpy(copy, *block, len + 1);
+    *block = copy;
+    return true;
+}
 
 CacheEntry* nextEmptyCacheEntry() {
-    for (int i = 0; i < WIFI_MGR_MAX_CONFIG_ENTRIES; i++) {
-        if (cache[i].name == nullptr) return &cache[i];
+    if (cacheCount >= WIFI_MGR_MAX_CONFIG_ENTRIES) return nullptr;
+    return &cache[cacheCount];
+}
+
+// takes the entry from nextEmptyCacheEntry() once its name and hash are set
+void indexCacheEntry(CacheEntry* entry) {
+    uint8_t pos = entry->hash & (WIFI_MGR_CONFIG_INDEX_SIZE - 1);
+    while (cacheIndex[pos] != 0) pos = (pos + 1) & (WIFI_MGR_CONFIG_INDEX_SIZE - 1);
+    cacheIndex[pos] = (entry - cache) + 1;
+    cacheCount++;
+}
+
+CacheEntry* findCacheEntry(const char* name, uint32_t hash) {
+    uint8_t pos = hash & (WIFI_MGR_CONFIG_INDEX_SIZE - 1);
+    while (cacheIndex[pos] != 0) {
+        CacheEntry* entry = &cache[cacheIndex[pos] - 1];
+        if (entry->hash == hash && strcmp(name, entry->name) == 0) return entry;
+        pos = (pos + 1) & (WIFI_MGR_CONFIG_INDEX_SIZE - 1);
     }
     return nullptr;
 }
 
+// adds the next entry with its name copied into the arena, the value is still unset
+CacheEntry* addCacheEntry(const char* name, uint8_t nameLen, uint32_t hash) {
+    CacheEntry* entry = nextEmptyCacheEntry();
+    if (entry == nullptr) return nullptr;
+    char* block = arenaAlloc(nameLen + 1);
+    if (block == nullptr) return nullptr;
+    memcpy(block, name, nameLen);
+    block[nameLen] = '\0';
+    entry->name = block;
+    entry->nameLen = nameLen;
+    entry->value = nullptr;
+    entry->valueLen = 0;
+    entry->valueCapacity = 0;
+    entry->hash = hash;
+    indexCacheEntry(entry);
+    return entry;
+}
+
+// bytes compaction would keep, without the value block of skip
+size_t arenaLiveSize(const CacheEntry* skip) {
+    size_t size = 0;
+    for (int i = 0; i < cacheCount; i++) {
+        if (inArena(cache[i].name)) size += cache[i].nameLen + 1;
+        if (inArena(cache[i].value) && &cache[i] != skip) size += cache[i].valueLen + 1;
+    }
+    return size;
+}
+
+// a value that does not fit leaves the entry as it was
+bool setCacheEntryValue(CacheEntry* entry, const char* value, uint8_t len) {
+    if (entry->value != nullptr && entry->valueLen == len && memcmp(entry->value, value, len) == 0) return true;
+    char* target;
+    if (inArena(entry->value) && len <= entry->valueCapacity) {
+        target = (char*) entry->value;
+    } else {
+        // compaction would move a source that is itself a config value
+        bool compact = !inArena(value);
+        // the old block is only given up for compaction once the new one is sure to fit
+        if (compact && inArena(entry->value) && arenaUsed + len + 1 > arenaSize && arenaLiveSize(entry) + len + 1 <= arenaSize) {
+            entry->value = nullptr;
+            entry->valueLen = 0;
+            entry->valueCapacity = 0;
+        }
+        target = arenaAlloc(len + 1, compact);
+        if (target == nullptr) return false;
+        entry->value = target;
+        entry->valueCapacity = len;
+    }
+    entry->dirty = true;
+    memmove(target, value, len);
+    target[len] = '\0';  // Ensure null termination
+    entry->valueLen = len;
+    return true;
+}
+
+void resetCache() {
+    for (int i = 0; i < cacheCount; i++) cache[i] = CacheEntry();
+    cacheCount = 0;
+    memset(cacheIndex, 0, sizeof(cacheIndex));
+    arenaUsed = 0;
+    rewriteImage = false;
+}
+
 void wifiMgrConfigureEEPROM(int startAddress, int size) {
     if (initialized) return;
     eepromStartAddress = startAddress;
     eepromSize = size;
 }
 
-bool wifiMgrSetupEEPROM() {
-    if (initialized) return true;
-    EEPROM.begin(eepromSize);
+// one pass over the mirror, entries point right into it
+bool loadEEPROM(bool* unterminated) {
+#if defined(ESP8266)
+    const uint8_t* data = EEPROM.getConstDataPtr();
+#elif defined(ESP32)
+    // the ESP32 core has no const accessor, this one also marks the mirror dirty for EEPROM.commit()
+    const uint8_t* data = EEPROM.getDataPtr();
+#endif
+    size_t end = eepromStartAddress + eepromSize;
+    if (EEPROM.length() < end) end = EEPROM.length();
+    if (data == nullptr || end < (size_t) eepromStartAddress + WIFI_MGR_EEPROM_HEADER_SIZE) return false;
+    mirror = (const char*) data + eepromStartAddress;
+    mirrorSize = end - eepromStartAddress;
+    const uint8_t* area = (const uint8_t*) mirror;
 
-    //EEPROM.r
-    uint8_t header1 = EEPROM.read(eepromStartAddress + 0);
-    uint8_t header2 = EEPROM.read(eepromStartAddress + 1);
-    uint8_t version1 = EEPROM.read(eepromStartAddress + 2);
-    uint8_t version2 = EEPROM.read(eepromStartAddress + 3);
-    uint8_t numberOfEntries = EEPROM.read(eepromStartAddress + 4);
-
-    if (header1 != 0x43 || header2 != 0x96 || version1 != 0x00 || version2 != 0x01) {
+    *unterminated = area[3] == WIFI_MGR_EEPROM_VERSION_2_UNTERMINATED;
+    if (area[0] != WIFI_MGR_EEPROM_HEADER_1 || area[1] != WIFI_MGR_EEPROM_HEADER_2 || area[2] != WIFI_MGR_EEPROM_VERSION_1 ||
+        (area[3] != WIFI_MGR_EEPROM_VERSION_2 && !*unterminated)) {
         // not initialized
         EEPROM.write(eepromStartAddress + 0, WIFI_MGR_EEPROM_HEADER_1);
         EEPROM.write(eepromStartAddress + 1, WIFI_MGR_EEPROM_HEADER_2);
         EEPROM.write(eepromStartAddress + 2, WIFI_MGR_EEPROM_VERSION_1);
         EEPROM.write(eepromStartAddress + 3, WIFI_MGR_EEPROM_VERSION_2);
         EEPROM.write(eepromStartAddress + 4, 0x00);
-        numberOfEntries = 0;
+        *unterminated = false;
+        return true;
     }
 
-    uint16_t eepromPtr = eepromStartAddress + 5;
+    uint8_t numberOfEntries = area[4];
+    uint8_t terminator = *unterminated ? 0 : 1;
+    size_t pos = WIFI_MGR_EEPROM_HEADER_SIZE;
     for (int i = 0; i < numberOfEntries; i++) {
-        uint8_t entryNameLength = EEPROM.read(eepromPtr);
-        uint8_t entryValueLength = EEPROM.read(eepromPtr + 1 + entryNameLength);
+        if (pos >= mirrorSize) return false;  // EEPROM space exceeded
+        uint8_t entryNameLength = area[pos];
+        size_t valuePos = pos + 1 + entryNameLength + terminator;
+        if (valuePos >= mirrorSize) return false;
+        uint8_t entryValueLength = area[valuePos];
+        size_t next = valuePos + 1 + entryValueLength + terminator;
+        if (next > mirrorSize) return false;
 
-        if (entryNameLength != 0 && entryValueLength != 0) {
+        // empty values are entries too, the cache has to match the layout of the image. A nameless
+        // record cannot be one, the differential commit would miss it, so the image is rewritten instead
+        if (entryNameLength == 0) rewriteImage = true;
+        if (entryNameLength != 0) {
+            const char* name = mirror + pos + 1;
+            const char* value = mirror + valuePos + 1;
+            if (*unterminated) {
+                // one allocation, compaction would not know about a name without its entry
+                char* copy = arenaAlloc(entryNameLength + 1 + entryValueLength + 1);
+                if (copy == nullptr) return false;  // No more space in the arena
+                memcpy(copy, name, entryNameLength);
+                copy[entryNameLength] = '\0';
+                memcpy(copy + entryNameLength + 1, value, entryValueLength);
+                copy[entryNameLength + 1 + entryValueLength] = '\0';
+                name = copy;
+                value = copy + entryNameLength + 1;
+            } else if (name[entryNameLength] != '\0' || value[entryValueLength] != '\0') {
+                return false;  // corrupt
+            }
             auto *newEntry = nextEmptyCacheEntry();
             if (newEntry == nullptr) {
                 return false;  // No more space in cache
             }
-            newEntry->name = new char[entryNameLength + 1];
-            newEntry->name[entryNameLength] = 0;
+            newEntry->name = name;
             newEntry->nameLen = entryNameLength;
-            newEntry->value = new char[entryValueLength + 1];
-            newEntry->value[entryValueLength] = 0;
+            newEntry->value = value;
             newEntry->valueLen = entryValueLength;
+            newEntry->valueCapacity = inArena(value) ? entryValueLength : 0;
+            newEntry->hash = wifiMgrConfigHash(name);
+            indexCacheEntry(newEntry);
+        }
+        pos = next;
+    }
+    return true;
+}
 
-            for (int ri = 0; ri < entryNameLength && ri < 256; ri++) {
-                newEntry->name[ri] = (char) EEPROM.read(eepromPtr + 1 + ri);
-            }
-            for (int ri = 0; ri < entryValueLength && ri < 256; ri++) {
-                newEntry->value[ri] = (char) EEPROM.read(eepromPtr + 2 + entryNameLength + ri);
+#if defined(WIFI_MGR_CONFIG_JOURNAL)
+bool replayFailed = false;
+
+void replayJournalRecord(const char* name, uint8_t nameLen, const char* value, uint8_t valueLen, uint32_t seq) {
+    uint32_t hash = wifiMgrConfigHash(name);
+    CacheEntry* entry = findCacheEntry(name, hash);
+    if (entry == nullptr) entry = addCacheEntry(name, nameLen, hash);
+    else if (seq <= entry->seq) return;
+    if (entry == nullptr || !setCacheEntryValue(entry, value, valueLen)) {
+        replayFailed = true;
+        return;
+    }
+    entry->seq = seq;
+    entry->dirty = false;
+}
+
+bool isJournalRecordLive(const char* name, uint8_t /* nameLen */, uint32_t seq) {
+    CacheEntry* entry = findCacheEntry(name, wifiMgrConfigHash(name));
+    return entry != nullptr && entry->seq == seq;
+}
+
+bool setupJournal() {
+    replayFailed = false;
+    if (!wifiMgrJournalBegin(replayJournalRecord, isJournalRecordLive) || replayFailed) return false;
+    initialized = true;
+    if (cacheCount > 0) return true;
+
+    // an empty journal starts with the entries of the EEPROM table, if there is one. An EEPROM the
+    // sketch has begun already stays as it is, only one begun here is ended again
+    bool ownEEPROM = EEPROM.length() == 0;
+    if (ownEEPROM) EEPROM.begin(eepromSize);
+    bool unterminated = false;
+    // checked here, loadEEPROM() would write a fresh header otherwise
+    uint8_t version2 = EEPROM.read(eepromStartAddress + 3);
+    bool hasTable = EEPROM.read(eepromStartAddress + 0) == WIFI_MGR_EEPROM_HEADER_1 &&
+                    EEPROM.read(eepromStartAddress + 1) == WIFI_MGR_EEPROM_HEADER_2 &&
+                    EEPROM.read(eepromStartAddress + 2) == WIFI_MGR_EEPROM_VERSION_1 &&
+                    (version2 == WIFI_MGR_EEPROM_VERSION_2 || version2 == WIFI_MGR_EEPROM_VERSION_2_UNTERMINATED);
+    // a table that fails to load is not imported at all, its entries would point into the freed mirror
+    hasTable = hasTable && loadEEPROM(&unterminated);
+    if (hasTable) {
+        for (int i = 0; i < cacheCount; i++) {
+            CacheEntry* entry = &cache[i];
+            if ((!inArena(entry->name) && !copyToArena(&entry->name, entry->nameLen)) ||
+                (!inArena(entry->value) && !copyToArena(&entry->value, entry->valueLen))) {
+                hasTable = false;
+                break;
             }
-        }
-        eepromPtr += 2 + entryNameLength + entryValueLength;
-        if (eepromPtr >= eepromStartAddress + eepromSize) {
-            return false;  // EEPROM space exceeded
+            entry->valueCapacity = entry->valueLen;
+            entry->dirty = true;
         }
     }
+    if (!hasTable) resetCache();
+    if (ownEEPROM) EEPROM.end();
+    mirror = nullptr;
+    mirrorSize = 0;
+    if (cacheCount > 0) wifiMgrCommitEEPROM();
+    return true;
+}
+#endif
+
+bool wifiMgrSetupEEPROM() {
+    if (initialized) return true;
+    // a load that failed half way must not leave duplicates behind
+    resetCache();
+    if (arena != nullptr && arenaSize != (size_t) eepromSize) {
+        delete[] arena;
+        arena = nullptr;
+        arenaSize = 0;
+    }
+#if defined(WIFI_MGR_CONFIG_JOURNAL)
+    return setupJournal();
+#else
+    EEPROM.begin(eepromSize);
+
+    bool unterminated = false;
+    if (!loadEEPROM(&unterminated)) return false;
     initialized = true;
+    // rewritten once, so the next boot can use the values in place
+    if (unterminated) {
+        rewriteImage = true;
+        wifiMgrCommitEEPROM();
+    }
     return true;
+#endif
+}
+CacheEntry* getCacheEntry(const char* name, uint32_t hash) {
+    if (!initialized && !wifiMgrSetupEEPROM()) return nullptr;
+    return findCacheEntry(name, hash);
 }
-CacheEntry* getCacheEntryByName(const char* name) {
-    if(!wifiMgrSetupEEPROM()) return nullptr;
-    for (int i = 0; i < WIFI_MGR_MAX_CONFIG_ENTRIES; i++) {
-        if (cache[i].name != nullptr && strcmp(name, cache[i].name) == 0) {
-            return &cache[i];
+CacheEntry* getOrAddCacheEntry(const char* name) {
+    uint32_t hash = wifiMgrConfigHash(name);
+    CacheEntry* cacheEntry = getCacheEntry(name, hash);
+    if (cacheEntry != nullptr || !initialized) return cacheEntry;
+
+    size_t len = strlen(name);
+    if (len == 0 || len > 255) return nullptr;  // the length is stored in one byte
+    return addCacheEntry(name, len, hash);
+}
+#if defined(WIFI_MGR_CONFIG_JOURNAL)
+bool wifiMgrCommitEEPROM() {
+    if (!wifiMgrSetupEEPROM()) return false;
+    // only changed entries are appended, replay lets the newest record of a name win
+    for (int i = 0; i < cacheCount; i++) {
+        CacheEntry* cacheEntry = &cache[i];
+        if (!cacheEntry->dirty || cacheEntry->value == nullptr) continue;
+        uint32_t seq;
+        if (!wifiMgrJournalAppend(cacheEntry->name, cacheEntry->nameLen, cacheEntry->value, cacheEntry->valueLen, &seq, isJournalRecordLive)) {
+            return false;
         }
+        cacheEntry->seq = seq;
+        cacheEntry->dirty = false;
     }
-    return nullptr;
+    return true;
 }
+#else
 bool wifiMgrCommitEEPROM() {
-    wifiMgrSetupEEPROM();
-    EEPROM.write(eepromStartAddress + 0, WIFI_MGR_EEPROM_HEADER_1);
-    EEPROM.write(eepromStartAddress + 1, WIFI_MGR_EEPROM_HEADER_2);
-    EEPROM.write(eepromStartAddress + 2, WIFI_MGR_EEPROM_VERSION_1);
-    EEPROM.write(eepromStartAddress + 3, WIFI_MGR_EEPROM_VERSION_2);
-    uint16_t eepromPtr = eepromStartAddress + 5;
+    if (!wifiMgrSetupEEPROM()) return false;
+
+    // entries before the first dirty one are in place already
+    int firstDirty = rewriteImage ? 0 : cacheCount;
+    for (int i = 0; i < firstDirty; i++) {
+        if (cache[i].dirty) {
+            firstDirty = i;
+            break;
+        }
+    }
+    if (firstDirty == cacheCount) return true;  // nothing changed, no flash write
+    size_t start = WIFI_MGR_EEPROM_HEADER_SIZE;
     uint8_t count = 0;
-    for (int i = 0; i < WIFI_MGR_MAX_CONFIG_ENTRIES; i++) {
-        CacheEntry cacheEntry = cache[i];
-        if (cacheEntry.value != nullptr && cacheEntry.name != nullptr) {
-            EEPROM.write(eepromPtr++, cacheEntry.nameLen);
-            for (unsigned int wi = 0; wi < cacheEntry.nameLen; wi++) {
-                EEPROM.write(eepromPtr++, cacheEntry.name[wi]);
-            }
-            EEPROM.write(eepromPtr++, cacheEntry.valueLen);
-            for (unsigned int wi = 0; wi < cacheEntry.valueLen; wi++) {
-                EEPROM.write(eepromPtr++, cacheEntry.value[wi]);
-            }
-            count++;
+    for (int i = 0; i < cacheCount; i++) {
+        if (cache[i].value == nullptr) continue;
+        if (i < firstDirty) start += cache[i].nameLen + cache[i].valueLen + WIFI_MGR_EEPROM_ENTRY_OVERHEAD;
+        count++;
+    }
+
+    // Everything still in the mirror that is going to move is copied first, the rewrite would
+    // overwrite it. Unchanged entries keep their place and are written over with the same bytes.
+    size_t pos = start;
+    for (int i = firstDirty; i < cacheCount; i++) {
+        CacheEntry* cacheEntry = &cache[i];
+        if (cacheEntry->value == nullptr) continue;
+        const char* name = mirror + pos + 1;
+        const char* value = name + cacheEntry->nameLen + 2;
+        if (!inArena(cacheEntry->name) && cacheEntry->name != name && !copyToArena(&cacheEntry->name, cacheEntry->nameLen)) return false;
+        if (!inArena(cacheEntry->value) && cacheEntry->value != value) {
+            if (!copyToArena(&cacheEntry->value, cacheEntry->valueLen)) return false;
+            cacheEntry->valueCapacity = cacheEntry->valueLen;
         }
+        pos += cacheEntry->nameLen + cacheEntry->valueLen + WIFI_MGR_EEPROM_ENTRY_OVERHEAD;
+    }
+    if (pos > mirrorSize) return false;  // EEPROM space exceeded
+
+    if (rewriteImage) {
+        EEPROM.write(eepromStartAddress + 0, WIFI_MGR_EEPROM_HEADER_1);
+        EEPROM.write(eepromStartAddress + 1, WIFI_MGR_EEPROM_HEADER_2);
+        EEPROM.write(eepromStartAddress + 2, WIFI_MGR_EEPROM_VERSION_1);
+        EEPROM.write(eepromStartAddress + 3, WIFI_MGR_EEPROM_VERSION_2);
     }
     EEPROM.write(eepromStartAddress + 4, count);
+    uint16_t eepromPtr = eepromStartAddress + start;
+    for (int i = firstDirty; i < cacheCount; i++) {
+        CacheEntry* cacheEntry = &cache[i];
+        if (cacheEntry->value == nullptr) continue;
+        EEPROM.write(eepromPtr++, cacheEntry->nameLen);
+        for (unsigned int wi = 0; wi <= cacheEntry->nameLen; wi++) {
+            EEPROM.write(eepromPtr++, cacheEntry->name[wi]);
+        }
+        EEPROM.write(eepromPtr++, cacheEntry->valueLen);
+        for (unsigned int wi = 0; wi <= cacheEntry->valueLen; wi++) {
+            EEPROM.write(eepromPtr++, cacheEntry->value[wi]);
+        }
+    }
+
+    // the mirror holds everything now, only names still waiting for a value stay in the arena
+    pos = start;
+    for (int i = firstDirty; i < cacheCount; i++) {
+        CacheEntry* cacheEntry = &cache[i];
+        cacheEntry->dirty = false;
+        if (cacheEntry->value == nullptr) continue;
+        cacheEntry->name = mirror + pos + 1;
+        cacheEntry->value = cacheEntry->name + cacheEntry->nameLen + 2;
+        cacheEntry->valueCapacity = 0;
+        pos += cacheEntry->nameLen + cacheEntry->valueLen + WIFI_MGR_EEPROM_ENTRY_OVERHEAD;
+    }
+    compactArena();
+    rewriteImage = false;
     return EEPROM.commit();
 }
+#endif
 void wifiMgrClearEEPROM() {
     if(!wifiMgrSetupEEPROM()) return;
-    for (int i = 0; i < WIFI_MGR_MAX_CONFIG_ENTRIES; i++) {
-        if (cache[i].name != nullptr) {
-            delete[] cache[i].name;
-            cache[i].name = nullptr;
-        }
-        cache[i].nameLen = 0;
-        if (cache[i].value != nullptr) {
-            delete[] cache[i].value;
-            cache[i].value = nullptr;
-        }
-        cache[i].valueLen = 0;
-    }
+    resetCache();
     initialized = false;
 }
-const char* wifiMgrGetConfig(const char* name) {
-    if(!wifiMgrSetupEEPROM()) return nullptr;
-    CacheEntry* cacheEntry = getCacheEntryByName(name);
+const char* wifiMgrGetConfig(const char* name, uint32_t hash) {
+    CacheEntry* cacheEntry = getCacheEntry(name, hash);
     if (cacheEntry == nullptr) return nullptr;
     else return cacheEntry->value;
 }
 bool wifiMgrSetConfig(const char* name, const char* value) {
-    if(!wifiMgrSetupEEPROM()) return false;
-    CacheEntry* cacheEntry = getCacheEntryByName(name);
-
-    if (cacheEntry == nullptr) {
-        cacheEntry = nextEmptyCacheEntry();
-        if (cacheEntry == nullptr) return false;
-
-        size_t len = strlen(name);
-        cacheEntry->name = new char[len + 1];
-        if (cacheEntry->name == nullptr) return false;
-        strncpy(cacheEntry->name, name, len);
-        cacheEntry->name[len] = '\0';  // Ensure null termination
-        cacheEntry->nameLen = len;
-    }
-
-    if (cacheEntry->value != nullptr) delete[] cacheEntry->value;
     size_t len = strlen(value);
-    cacheEntry->value = new char[len + 1];
-    if (cacheEntry->value == nullptr) return false;
-    strncpy(cacheEntry->value, value, len);
-    cacheEntry->value[len] = '\0';  // Ensure null termination
-    cacheEntry->valueLen = len;
-    return true;
+    if (len > 255) return false;  // the length is stored in one byte
+    return wifiMgrSetConfig(name, value, len);
 }
 bool wifiMgrSetConfig(const char* name, const char* value, uint8_t len) {
-    if(!wifiMgrSetupEEPROM()) return false;
-    CacheEntry* cacheEntry = getCacheEntryByName(name);
-
-    if (cacheEntry == nullptr) {
-        cacheEntry = nextEmptyCacheEntry();
-        if (cacheEntry == nullptr) return false;
-
-        size_t nameLen = strlen(name);
-        cacheEntry->name = new char[nameLen + 1];
-        if (cacheEntry->name == nullptr) return false;
-        strncpy(cacheEntry->name, name, nameLen);
-        cacheEntry->name[nameLen] = '\0';  // Ensure null termination
-        cacheEntry->nameLen = nameLen;
-    }
-
-    if (cacheEntry->value != nullptr) delete[] cacheEntry->value;
-    cacheEntry->value = new char[len + 1];
-    if (cacheEntry->value == nullptr) return false;
-    for (uint16_t wi = 0; wi < len; wi++) {
-        cacheEntry->value[wi] = (char) value[wi];
-    }
-    cacheEntry->value[len] = '\0';  // Ensure null termination
-    cacheEntry->valueLen = len;
-    return true;
+    CacheEntry* cacheEntry = getOrAddCacheEntry(name);
+    if (cacheEntry == nullptr) return false;
+    return setCacheEntryValue(cacheEntry, value, len);
 }
-long wifiMgrGetLongConfig(const char* name, long def) {
+long wifiMgrGetLongConfig(const char* name, uint32_t hash, long def) {
     long load;
-    CacheEntry* cacheEntry = getCacheEntryByName(name);
+    CacheEntry* cacheEntry = getCacheEntry(name, hash);
     if (cacheEntry == nullptr || cacheEntry->valueLen != 4) {
         return def;
     }
@@ -220,9 +520,9 @@ bool wifiMgrSetLongConfig(const char* name, long val) {
     tmp[3] = val & 0xFF;
     return wifiMgrSetConfig(name, tmp, 4);
 }
-unsigned long wifiMgrGetUlongConfig(const char* name, unsigned long def) {
+unsigned long wifiMgrGetUlongConfig(const char* name, uint32_t hash, unsigned long def) {
     unsigned long load;
-    CacheEntry* cacheEntry = getCacheEntryByName(name);
+    CacheEntry* cacheEntry = getCacheEntry(name, hash);
     if (cacheEntry == nullptr || cacheEntry->valueLen != 4) {
         return def;
     }
@@ -241,8 +541,8 @@ bool wifiMgrSetUlongConfig(const char* name, unsigned long val) {
     tmp[3] = val & 0xFF;
     return wifiMgrSetConfig(name, tmp, 4);
 }
-bool wifiMgrGetBoolConfig(const char* name, bool def) {
-    CacheEntry* cacheEntry = getCacheEntryByName(name);
+bool wifiMgrGetBoolConfig(const char* name, uint32_t hash, bool def) {
+    CacheEntry* cacheEntry = getCacheEntry(name, hash);
     if (cacheEntry == nullptr || cacheEntry->valueLen != 1) {
         return def;
     }
@@ -252,4 +552,4 @@ bool wifiMgrSetBoolConfig(const char* name, bool val) {
     char tmp[1] = {0};
     if (val) tmp[0] = 1;
     return wifiMgrSetConfig(name, tmp, 1);
-}
\ No newline at end of file
+}
@@ -0,0 +1,174 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#include "wifi_mgr_events.h"
+#include "wifi_mgr_stats.h"
+#include <stdarg.h>
+#if defined(ESP32)
+#include <lwip/sockets.h>
+#endif
+
+#define WIFI_MGR_EVENTS_CHECK_INTERVAL 250
+#define WIFI_MGR_EVENTS_HEARTBEAT_INTERVAL 15000
+#define WIFI_MGR_EVENTS_RSSI_BUCKET 5
+// target for wifiMgrEventsSend(): every subscriber
+#define WIFI_MGR_EVENTS_ALL -1
+
+// the copy of the server's client keeps the connection open after the handler returned
+WiFiClient wifiMgrEventsClients[WIFI_MGR_EVENTS_MAX_CLIENTS];
+bool wifiMgrEventsActive[WIFI_MGR_EVENTS_MAX_CLIENTS];
+uint8_t wifiMgrEventsCount = 0;
+unsigned long wifiMgrEventsLastCheck = 0;
+unsigned long wifiMgrEventsLastSend = 0;
+
+// last state that was pushed
+WifiMgrConnectPhase wifiMgrEventsPhase = WIFI_MGR_IDLE;
+uint8_t wifiMgrEventsBssid[6];
+int8_t wifiMgrEventsRssiBucket = 0;
+uint32_t wifiMgrEventsMinHeap = UINT32_MAX;
+uint32_t wifiMgrEventsReportedHeap = UINT32_MAX;
+
+// returns false if the client could not take all of it right now
+bool wifiMgrEventsWrite(uint8_t slot, const char* data, size_t len) {
+    WiFiClient* client = &wifiMgrEventsClients[slot];
+    if (!client->connected()) return false;
+#if defined(ESP8266)
+    if ((size_t) client->availableForWrite() < len) return false;
+    return client->write((const uint8_t*) data, len) == len;
+#elif defined(ESP32)
+    // WiFiClient::write() retries for seconds on a full socket, go around it
+    int fd = client->fd();
+    if (fd < 0) return false;
+    return send(fd, data, len, MSG_DONTWAIT) == (int) len;
+#endif
+}
+
+void wifiMgrEventsDrop(uint8_t slot) {
+    wifiMgrEventsClients[slot].stop();
+    wifiMgrEventsClients[slot] = WiFiClient();
+    wifiMgrEventsActive[slot] = false;
+    wifiMgrEventsCount--;
+}
+
+void wifiMgrEventsSendRaw(int8_t target, const char* data, size_t len) {
+    for (uint8_t i = 0; i < WIFI_MGR_EVENTS_MAX_CLIENTS; i++) {
+        if (!wifiMgrEventsActive[i] || (target != WIFI_MGR_EVENTS_ALL && target != i)) continue;
+        // a partially written event would corrupt the stream, so slow clients are dropped
+        if (!wifiMgrEventsWrite(i, data, len)) wifiMgrEventsDrop(i);
+    }
+    wifiMgrEventsLastSend = millis();
+}
+
+void wifiMgrEventsSend(int8_t target, const char* event, const char* format, ...) {
+    char buffer[160];
+    // a truncated event is not sent at all, each step checks before the next one writes behind it
+    int len = snprintf(buffer, sizeof(buffer), "event: %s\ndata: ", event);
+    if (len < 0 || (size_t) len >= sizeof(buffer)) return;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer + len, sizeof(buffer) - len, format, args);
+    va_end(args);
+    if (written < 0 || (size_t) written >= sizeof(buffer) - len) return;
+    len += written;
+    written = snprintf(buffer + len, sizeof(buffer) - len, "\n\n");
+    if (written < 0 || (size_t) written >= sizeof(buffer) - len) return;
+    len += written;
+    wifiMgrEventsSendRaw(target, buffer, len);
+}
+
+void wifiMgrEventsSendPhase(int8_t target) {
+    wifiMgrEventsSend(target, "phase", "{\"phase\":\"%s\",\"connected\":%s,\"ip\":\"%s\"}", wifiMgrGetConnectPhaseName(),
+                      wifiMgrEventsPhase == WIFI_MGR_CONNECTED ? "true" : "false", WiFi.localIP().toString().c_str());
+}
+
+void wifiMgrEventsSendBssid(int8_t target) {
+    wifiMgrEventsSend(target, "bssid", "{\"bssid\":\"%02x:%02x:%02x:%02x:%02x:%02x\",\"channel\":%d}",
+                      wifiMgrEventsBssid[0], wifiMgrEventsBssid[1], wifiMgrEventsBssid[2], wifiMgrEventsBssid[3], wifiMgrEventsBssid[4], wifiMgrEventsBssid[5],
+                      (int) WiFi.channel());
+}
+
+void wifiMgrEventsSendRssi(int8_t target) {
+    wifiMgrEventsSend(target, "rssi", "{\"rssi\":%d,\"bucket\":%d}", wifiMgrStatsSmoothedRssi(), wifiMgrEventsRssiBucket);
+}
+
+void wifiMgrEventsSendHeap(int8_t target) {
+    wifiMgrEventsSend(target, "heap", "{\"free\":%lu,\"min\":%lu}", (unsigned long) ESP.getFreeHeap(), (unsigned long) wifiMgrEventsMinHeap);
+}
+
+void wifiMgrEventsSubscribe(XWebServer* server) {
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < WIFI_MGR_EVENTS_MAX_CLIENTS; i++) {
+        if (wifiMgrEventsActive[i] && !wifiMgrEventsClients[i].connected()) wifiMgrEventsDrop(i);
+        if (!wifiMgrEventsActive[i] && slot < 0) slot = i;
+    }
+    if (slot < 0) {
+        server->send(503, "text/plain", "too many subscribers");
+        return;
+    }
+    wifiMgrEventsClients[slot] = server->client();
+    wifiMgrEventsActive[slot] = true;
+    wifiMgrEventsCount++;
+    WiFiClient* client = &wifiMgrEventsClients[slot];
+    client->setNoDelay(true);
+#if defined(ESP8266)
+    client->setSync(false);
+#endif
+    // written directly, the server would add a Content-Length
+    const char* header = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nConnection: keep-alive\r\n\r\nretry: 5000\n\n";
+    wifiMgrEventsSendRaw(slot, header, strlen(header));
+    if (!wifiMgrEventsActive[slot]) return;
+
+    // snapshot, from here on the subscriber only gets changes
+    wifiMgrEventsSendPhase(slot);
+    if (wifiMgrEventsPhase == WIFI_MGR_CONNECTED) {
+        wifiMgrEventsSendBssid(slot);
+        if (wifiMgrEventsRssiBucket != 0) wifiMgrEventsSendRssi(slot);
+    }
+    wifiMgrEventsSendHeap(slot);
+}
+
+void wifiMgrEventsLoop() {
+    if (millis() - wifiMgrEventsLastCheck < WIFI_MGR_EVENTS_CHECK_INTERVAL) return;
+    wifiMgrEventsLastCheck = millis();
+
+    // tracked even without subscribers, so the first one gets the real low watermark
+    uint32_t heap = ESP.getFreeHeap();
+    if (heap < wifiMgrEventsMinHeap) wifiMgrEventsMinHeap = heap;
+    if (wifiMgrEventsReportedHeap == UINT32_MAX) wifiMgrEventsReportedHeap = wifiMgrEventsMinHeap;
+    WifiMgrConnectPhase phase = wifiMgrGetConnectPhase();
+    bool phaseChanged = phase != wifiMgrEventsPhase;
+    wifiMgrEventsPhase = phase;
+
+    bool bssidChanged = false;
+    int8_t rssiBucket = 0;
+    if (phase == WIFI_MGR_CONNECTED) {
+        uint8_t* bssid = WiFi.BSSID();
+        if (bssid != nullptr && memcmp(bssid, wifiMgrEventsBssid, 6) != 0) {
+            memcpy(wifiMgrEventsBssid, bssid, 6);
+            bssidChanged = true;
+        }
+        int8_t rssi = wifiMgrStatsSmoothedRssi();
+        // floor to the bucket, RSSI is negative
+        if (rssi < 0) rssiBucket = -((-rssi + WIFI_MGR_EVENTS_RSSI_BUCKET - 1) / WIFI_MGR_EVENTS_RSSI_BUCKET) * WIFI_MGR_EVENTS_RSSI_BUCKET;
+    } else {
+        memset(wifiMgrEventsBssid, 0, 6);
+    }
+    bool rssiChanged = rssiBucket != wifiMgrEventsRssiBucket;
+    wifiMgrEventsRssiBucket = rssiBucket;
+
+    if (wifiMgrEventsCount == 0) return;
+    if (phaseChanged) wifiMgrEventsSendPhase(WIFI_MGR_EVENTS_ALL);
+    if (bssidChanged) wifiMgrEventsSendBssid(WIFI_MGR_EVENTS_ALL);
+    if (rssiChanged && rssiBucket != 0) wifiMgrEventsSendRssi(WIFI_MGR_EVENTS_ALL);
+    if (wifiMgrEventsReportedHeap - wifiMgrEventsMinHeap >= WIFI_MGR_EVENTS_HEAP_STEP) {
+        wifiMgrEventsReportedHeap = wifiMgrEventsMinHeap;
+        wifiMgrEventsSendHeap(WIFI_MGR_EVENTS_ALL);
+    }
+    // comment line as heartbeat, also finds clients that went away
+    if (millis() - wifiMgrEventsLastSend > WIFI_MGR_EVENTS_HEARTBEAT_INTERVAL) wifiMgrEventsSendRaw(WIFI_MGR_EVENTS_ALL, ":\n\n", 3);
+}
+
+void wifiMgrEventsStop() {
+    for (uint8_t i = 0; i < WIFI_MGR_EVENTS_MAX_CLIENTS; i++) {
+        if (wifiMgrEventsActive[i]) wifiMgrEventsDrop(i);
+    }
+}
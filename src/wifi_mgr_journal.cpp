@@ -0,0 +1,321 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#include "wifi_mgr_journal.h"
+
+#if defined(WIFI_MGR_CONFIG_JOURNAL)
+
+#if defined(ESP8266)
+#ifndef WIFI_MGR_JOURNAL_FIRST_SECTOR
+#error "WIFI_MGR_CONFIG_JOURNAL needs WIFI_MGR_JOURNAL_FIRST_SECTOR, the first of WIFI_MGR_JOURNAL_SECTORS free flash sectors"
+#endif
+#elif defined(ESP32)
+#include <esp_partition.h>
+#endif
+
+//  SECTOR
+// MAGIC GENERATION, then records up to the first erased word:
+// SEQ NAME_LENGTH VALUE_LENGTH CHECKSUM CHECKSUM NAME... VALUE... padded to 4 bytes with 0xFF
+
+#define WIFI_MGR_JOURNAL_SECTOR_SIZE 4096
+#define WIFI_MGR_JOURNAL_MAGIC 0x314A4D57 // "WMJ1"
+#define WIFI_MGR_JOURNAL_SECTOR_HEADER 8
+#define WIFI_MGR_JOURNAL_RECORD_HEADER 8
+#define WIFI_MGR_JOURNAL_ERASED 0xFFFFFFFF
+
+static_assert(WIFI_MGR_JOURNAL_SECTORS >= 2, "the journal needs a spare sector");
+
+enum WifiMgrJournalSectorState {
+    WIFI_MGR_JOURNAL_SECTOR_ERASED,
+    WIFI_MGR_JOURNAL_SECTOR_USED,
+    WIFI_MGR_JOURNAL_SECTOR_STALE // needs an erase before it can be used
+};
+
+uint8_t wifiMgrJournalSectorCount = 0;
+WifiMgrJournalSectorState wifiMgrJournalState[WIFI_MGR_JOURNAL_SECTORS];
+uint32_t wifiMgrJournalGeneration[WIFI_MGR_JOURNAL_SECTORS];
+uint8_t wifiMgrJournalHead = 0;
+uint32_t wifiMgrJournalHeadPos = 0;
+// end of the intact records in the head, a torn write leaves wifiMgrJournalHeadPos behind it
+uint32_t wifiMgrJournalHeadEnd = 0;
+uint32_t wifiMgrJournalSeq = 0;
+// one record of the longest name and value, plus room to terminate both
+uint32_t wifiMgrJournalBuffer[(WIFI_MGR_JOURNAL_RECORD_HEADER + 255 + 255 + 2 + 3) / 4];
+#if defined(ESP32)
+const esp_partition_t* wifiMgrJournalPartition = nullptr;
+#endif
+
+bool wifiMgrJournalRead(uint8_t sector, uint32_t offset, uint32_t* data, size_t size) {
+#if defined(ESP8266)
+    return ESP.flashRead((WIFI_MGR_JOURNAL_FIRST_SECTOR + sector) * WIFI_MGR_JOURNAL_SECTOR_SIZE + offset, data, size);
+#elif defined(ESP32)
+    return esp_partition_read(wifiMgrJournalPartition, sector * WIFI_MGR_JOURNAL_SECTOR_SIZE + offset, data, size) == ESP_OK;
+#endif
+}
+
+bool wifiMgrJournalWrite(uint8_t sector, uint32_t offset, uint32_t* data, size_t size) {
+#if defined(ESP8266)
+    return ESP.flashWrite((WIFI_MGR_JOURNAL_FIRST_SECTOR + sector) * WIFI_MGR_JOURNAL_SECTOR_SIZE + offset, data, size);
+#elif defined(ESP32)
+    return esp_partition_write(wifiMgrJournalPartition, sector * WIFI_MGR_JOURNAL_SECTOR_SIZE + offset, data, size) == ESP_OK;
+#endif
+}
+
+bool wifiMgrJournalErase(uint8_t sector) {
+#if defined(ESP8266)
+    bool ok = ESP.flashEraseSector(WIFI_MGR_JOURNAL_FIRST_SECTOR + sector);
+#elif defined(ESP32)
+    bool ok = esp_partition_erase_range(wifiMgrJournalPartition, sector * WIFI_MGR_JOURNAL_SECTOR_SIZE, WIFI_MGR_JOURNAL_SECTOR_SIZE) == ESP_OK;
+#endif
+    if (ok) wifiMgrJournalState[sector] = WIFI_MGR_JOURNAL_SECTOR_ERASED;
+    return ok;
+}
+
+uint32_t wifiMgrJournalRecordSize(uint8_t nameLen, uint8_t valueLen) {
+    return WIFI_MGR_JOURNAL_RECORD_HEADER + ((nameLen + valueLen + 3) & ~3);
+}
+
+// FNV-1a over seq, both lengths and the payload, folded to 16 bits
+uint16_t wifiMgrJournalChecksum() {
+    const uint8_t* record = (const uint8_t*) wifiMgrJournalBuffer;
+    size_t payloadLen = record[4] + record[5];
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < WIFI_MGR_JOURNAL_RECORD_HEADER + payloadLen; i++) {
+        if (i == 6 || i == 7) continue;
+        hash ^= record[i];
+        hash *= 16777619UL;
+    }
+    return (hash >> 16) ^ (hash & 0xFFFF);
+}
+
+// 1: the record at pos is in the buffer, 0: end of the sector, -1: torn or corrupt
+int8_t wifiMgrJournalReadRecord(uint8_t sector, uint32_t pos, uint32_t* size) {
+    if (pos + WIFI_MGR_JOURNAL_RECORD_HEADER > WIFI_MGR_JOURNAL_SECTOR_SIZE) return 0;
+    if (!wifiMgrJournalRead(sector, pos, wifiMgrJournalBuffer, WIFI_MGR_JOURNAL_RECORD_HEADER)) return -1;
+    if (wifiMgrJournalBuffer[0] == WIFI_MGR_JOURNAL_ERASED && wifiMgrJournalBuffer[1] == WIFI_MGR_JOURNAL_ERASED) return 0;
+    const uint8_t* record = (const uint8_t*) wifiMgrJournalBuffer;
+    *size = wifiMgrJournalRecordSize(record[4], record[5]);
+    if (pos + *size > WIFI_MGR_JOURNAL_SECTOR_SIZE) return -1;
+    if (*size > WIFI_MGR_JOURNAL_RECORD_HEADER &&
+        !wifiMgrJournalRead(sector, pos + WIFI_MGR_JOURNAL_RECORD_HEADER, wifiMgrJournalBuffer + 2, *size - WIFI_MGR_JOURNAL_RECORD_HEADER)) {
+        return -1;
+    }
+    if (wifiMgrJournalChecksum() != (record[6] | (record[7] << 8))) return -1;
+    return 1;
+}
+
+// moves the value of the buffered record one byte up, so name and value can be handed out terminated
+void wifiMgrJournalTerminate(bool terminate) {
+    const uint8_t* record = (const uint8_t*) wifiMgrJournalBuffer;
+    char* payload = (char*) (wifiMgrJournalBuffer + 2);
+    uint8_t nameLen = record[4];
+    uint8_t valueLen = record[5];
+    if (terminate) {
+        memmove(payload + nameLen + 1, payload + nameLen, valueLen);
+        payload[nameLen] = '\0';
+        payload[nameLen + 1 + valueLen] = '\0';
+    } else {
+        memmove(payload + nameLen, payload + nameLen + 1, valueLen);
+        // restore the padding the checksum does not cover
+        memset(payload + nameLen + valueLen, 0xFF, wifiMgrJournalRecordSize(nameLen, valueLen) - WIFI_MGR_JOURNAL_RECORD_HEADER - nameLen - valueLen);
+    }
+}
+
+bool wifiMgrJournalOpenSector(uint8_t sector, uint32_t generation) {
+    if (wifiMgrJournalState[sector] != WIFI_MGR_JOURNAL_SECTOR_ERASED && !wifiMgrJournalErase(sector)) return false;
+    uint32_t header[2] = {WIFI_MGR_JOURNAL_MAGIC, generation};
+    // a torn header reads back as garbage and is erased again on the next boot
+    wifiMgrJournalState[sector] = WIFI_MGR_JOURNAL_SECTOR_STALE;
+    if (!wifiMgrJournalWrite(sector, 0, header, sizeof(header))) return false;
+    wifiMgrJournalState[sector] = WIFI_MGR_JOURNAL_SECTOR_USED;
+    wifiMgrJournalGeneration[sector] = generation;
+    wifiMgrJournalHead = sector;
+    wifiMgrJournalHeadPos = WIFI_MGR_JOURNAL_SECTOR_HEADER;
+    wifiMgrJournalHeadEnd = wifiMgrJournalHeadPos;
+    return true;
+}
+
+// true if the intact part of the head holds a record with this seq, only reads the record headers
+bool wifiMgrJournalHeadContains(uint32_t seq) {
+    uint32_t pos = WIFI_MGR_JOURNAL_SECTOR_HEADER;
+    uint32_t header[2];
+    while (pos < wifiMgrJournalHeadEnd && wifiMgrJournalRead(wifiMgrJournalHead, pos, header, sizeof(header))) {
+        if (header[0] == seq) return true;
+        const uint8_t* bytes = (const uint8_t*) header;
+        pos += wifiMgrJournalRecordSize(bytes[4], bytes[5]);
+    }
+    return false;
+}
+
+// copies the live records of the oldest sector into the head, it is erased later
+bool wifiMgrJournalReclaim(uint8_t oldest, WifiMgrJournalLiveCheck isLive, bool skipCopied) {
+    uint32_t pos = WIFI_MGR_JOURNAL_SECTOR_HEADER;
+    uint32_t size = 0;
+    while (wifiMgrJournalReadRecord(oldest, pos, &size) == 1) {
+        pos += size;
+        wifiMgrJournalTerminate(true);
+        const uint8_t* record = (const uint8_t*) wifiMgrJournalBuffer;
+        bool live = isLive((const char*) (wifiMgrJournalBuffer + 2), record[4], wifiMgrJournalBuffer[0]);
+        if (!live || (skipCopied && wifiMgrJournalHeadContains(wifiMgrJournalBuffer[0]))) continue;
+        wifiMgrJournalTerminate(false);
+        // copied as is, with its seq
+        if (wifiMgrJournalHeadPos + size > WIFI_MGR_JOURNAL_SECTOR_SIZE) return false;
+        if (!wifiMgrJournalWrite(wifiMgrJournalHead, wifiMgrJournalHeadPos, wifiMgrJournalBuffer, size)) {
+            // like a torn append, nothing goes behind it
+            wifiMgrJournalHeadPos = WIFI_MGR_JOURNAL_SECTOR_SIZE;
+            return false;
+        }
+        wifiMgrJournalHeadPos += size;
+        wifiMgrJournalHeadEnd = wifiMgrJournalHeadPos;
+    }
+    wifiMgrJournalState[oldest] = WIFI_MGR_JOURNAL_SECTOR_STALE;
+    return true;
+}
+
+// Last resort for a reclaim the head had no room to finish (e.g. a torn copy): the live records of the
+// oldest sector that are not in the head yet are held in RAM while it is erased and reopened as the head,
+// then the ring goes on with the sector after it. A power loss in between loses those records.
+bool wifiMgrJournalRecycle(uint8_t oldest, WifiMgrJournalLiveCheck isLive) {
+    uint32_t* saved = new uint32_t[WIFI_MGR_JOURNAL_SECTOR_SIZE / 4];
+    if (saved == nullptr) return false;
+    uint32_t savedSize = 0;
+    uint32_t pos = WIFI_MGR_JOURNAL_SECTOR_HEADER;
+    uint32_t size = 0;
+    while (wifiMgrJournalReadRecord(oldest, pos, &size) == 1) {
+        pos += size;
+        wifiMgrJournalTerminate(true);
+        const uint8_t* record = (const uint8_t*) wifiMgrJournalBuffer;
+        bool live = isLive((const char*) (wifiMgrJournalBuffer + 2), record[4], wifiMgrJournalBuffer[0]);
+        if (!live || wifiMgrJournalHeadContains(wifiMgrJournalBuffer[0])) continue;
+        wifiMgrJournalTerminate(false);
+        memcpy((uint8_t*) saved + savedSize, wifiMgrJournalBuffer, size);
+        savedSize += size;
+    }
+    bool ok = wifiMgrJournalOpenSector(oldest, wifiMgrJournalGeneration[wifiMgrJournalHead] + 1) &&
+              (savedSize == 0 || wifiMgrJournalWrite(oldest, WIFI_MGR_JOURNAL_SECTOR_HEADER, saved, savedSize));
+    delete[] saved;
+    if (!ok) {
+        wifiMgrJournalHeadPos = WIFI_MGR_JOURNAL_SECTOR_SIZE;
+        return false;
+    }
+    wifiMgrJournalHeadPos += savedSize;
+    wifiMgrJournalHeadEnd = wifiMgrJournalHeadPos;
+
+    uint8_t next = (oldest + 1) % wifiMgrJournalSectorCount;
+    if (wifiMgrJournalState[next] != WIFI_MGR_JOURNAL_SECTOR_USED || next == oldest) return true;
+    return wifiMgrJournalReclaim(next, isLive, false);
+}
+
+bool wifiMgrJournalBegin(WifiMgrJournalRecordHandler handler, WifiMgrJournalLiveCheck isLive) {
+#if defined(ESP8266)
+    wifiMgrJournalSectorCount = WIFI_MGR_JOURNAL_SECTORS;
+#elif defined(ESP32)
+    wifiMgrJournalPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, WIFI_MGR_JOURNAL_PARTITION);
+    if (wifiMgrJournalPartition == nullptr) return false;
+    uint32_t partitionSectors = wifiMgrJournalPartition->size / WIFI_MGR_JOURNAL_SECTOR_SIZE;
+    if (partitionSectors < 2) return false;
+    wifiMgrJournalSectorCount = partitionSectors < WIFI_MGR_JOURNAL_SECTORS ? partitionSectors : WIFI_MGR_JOURNAL_SECTORS;
+#endif
+
+    int8_t head = -1;
+    for (uint8_t i = 0; i < wifiMgrJournalSectorCount; i++) {
+        uint32_t header[2];
+        if (!wifiMgrJournalRead(i, 0, header, sizeof(header))) return false;
+        if (header[0] == WIFI_MGR_JOURNAL_MAGIC) {
+            wifiMgrJournalState[i] = WIFI_MGR_JOURNAL_SECTOR_USED;
+            wifiMgrJournalGeneration[i] = header[1];
+            if (head < 0 || header[1] > wifiMgrJournalGeneration[head]) head = i;
+        } else if (header[0] == WIFI_MGR_JOURNAL_ERASED && header[1] == WIFI_MGR_JOURNAL_ERASED) {
+            wifiMgrJournalState[i] = WIFI_MGR_JOURNAL_SECTOR_ERASED;
+        } else {
+            wifiMgrJournalState[i] = WIFI_MGR_JOURNAL_SECTOR_STALE;
+        }
+    }
+    wifiMgrJournalSeq = 0;
+    if (head < 0) return wifiMgrJournalOpenSector(0, 1);
+    wifiMgrJournalHead = head;
+
+    // the order does not matter for the result, the highest seq per name wins anyway
+    for (uint8_t i = 0; i < wifiMgrJournalSectorCount; i++) {
+        if (wifiMgrJournalState[i] != WIFI_MGR_JOURNAL_SECTOR_USED) continue;
+        uint32_t pos = WIFI_MGR_JOURNAL_SECTOR_HEADER;
+        uint32_t size = 0;
+        int8_t result;
+        while ((result = wifiMgrJournalReadRecord(i, pos, &size)) == 1) {
+            wifiMgrJournalTerminate(true);
+            const uint8_t* record = (const uint8_t*) wifiMgrJournalBuffer;
+            const char* name = (const char*) (wifiMgrJournalBuffer + 2);
+            handler(name, record[4], name + record[4] + 1, record[5], wifiMgrJournalBuffer[0]);
+            if (wifiMgrJournalBuffer[0] > wifiMgrJournalSeq) wifiMgrJournalSeq = wifiMgrJournalBuffer[0];
+            pos += size;
+        }
+        // nothing is appended behind a torn record, the next append opens a new sector
+        if (i == wifiMgrJournalHead) {
+            wifiMgrJournalHeadPos = result == 0 ? pos : WIFI_MGR_JOURNAL_SECTOR_SIZE;
+            wifiMgrJournalHeadEnd = pos;
+        }
+    }
+
+    // every sector in use: a reclaim was cut short, the stale state only lives in RAM
+    uint8_t oldest = (wifiMgrJournalHead + 1) % wifiMgrJournalSectorCount;
+    if (wifiMgrJournalState[oldest] == WIFI_MGR_JOURNAL_SECTOR_USED) {
+        bool spare = false;
+        for (uint8_t i = 0; i < wifiMgrJournalSectorCount; i++) {
+            if (wifiMgrJournalState[i] != WIFI_MGR_JOURNAL_SECTOR_USED) spare = true;
+        }
+        // without room in the head the next append recycles the oldest sector instead
+        if (!spare) wifiMgrJournalReclaim(oldest, isLive, true);
+    }
+    return true;
+}
+
+// Opens the sector after the head. If no erased or stale sector is left after that, the oldest
+// one is reclaimed: its live records are copied into the new head and it is erased later.
+bool wifiMgrJournalAdvance(WifiMgrJournalLiveCheck isLive) {
+    uint8_t next = (wifiMgrJournalHead + 1) % wifiMgrJournalSectorCount;
+    // a reclaim that ran out of room left the oldest sector in use
+    if (wifiMgrJournalState[next] == WIFI_MGR_JOURNAL_SECTOR_USED) return wifiMgrJournalRecycle(next, isLive);
+    if (!wifiMgrJournalOpenSector(next, wifiMgrJournalGeneration[wifiMgrJournalHead] + 1)) return false;
+
+    uint8_t oldest = (next + 1) % wifiMgrJournalSectorCount;
+    if (wifiMgrJournalState[oldest] != WIFI_MGR_JOURNAL_SECTOR_USED) return true;
+    return wifiMgrJournalReclaim(oldest, isLive, false);
+}
+
+bool wifiMgrJournalAppend(const char* name, uint8_t nameLen, const char* value, uint8_t valueLen, uint32_t* seq,
+                          WifiMgrJournalLiveCheck isLive) {
+    uint32_t size = wifiMgrJournalRecordSize(nameLen, valueLen);
+    if (wifiMgrJournalHeadPos + size > WIFI_MGR_JOURNAL_SECTOR_SIZE && !wifiMgrJournalAdvance(isLive)) return false;
+    if (wifiMgrJournalHeadPos + size > WIFI_MGR_JOURNAL_SECTOR_SIZE) return false;  // the live config does not fit a sector
+
+    uint8_t* record = (uint8_t*) wifiMgrJournalBuffer;
+    memset(record, 0xFF, size);
+    wifiMgrJournalBuffer[0] = wifiMgrJournalSeq + 1;
+    record[4] = nameLen;
+    record[5] = valueLen;
+    memcpy(record + WIFI_MGR_JOURNAL_RECORD_HEADER, name, nameLen);
+    memcpy(record + WIFI_MGR_JOURNAL_RECORD_HEADER + nameLen, value, valueLen);
+    uint16_t checksum = wifiMgrJournalChecksum();
+    record[6] = checksum & 0xFF;
+    record[7] = checksum >> 8;
+    if (!wifiMgrJournalWrite(wifiMgrJournalHead, wifiMgrJournalHeadPos, wifiMgrJournalBuffer, size)) {
+        // whatever made it to the flash is skipped on the next boot, nothing goes behind it
+        wifiMgrJournalHeadPos = WIFI_MGR_JOURNAL_SECTOR_SIZE;
+        return false;
+    }
+    wifiMgrJournalHeadPos += size;
+    wifiMgrJournalHeadEnd = wifiMgrJournalHeadPos;
+    *seq = ++wifiMgrJournalSeq;
+    return true;
+}
+
+void wifiMgrJournalLoop() {
+    for (uint8_t i = 0; i < wifiMgrJournalSectorCount; i++) {
+        if (wifiMgrJournalState[i] == WIFI_MGR_JOURNAL_SECTOR_STALE) {
+            // one per call, an erase blocks for tens of milliseconds
+            wifiMgrJournalErase(i);
+            return;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,185 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#include "wifi_mgr_json.h"
+#include <limits.h>
+
+void wifiMgrJsonWriteString(WifiMgrChunkWriter* writer, const char* value) {
+    if (value == nullptr) {
+        wifiMgrChunkWrite(writer, "null", 4);
+        return;
+    }
+    wifiMgrChunkWrite(writer, "\"", 1);
+    const char* start = value;
+    for (; *value != 0; value++) {
+        unsigned char c = *value;
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+        wifiMgrChunkWrite(writer, start, value - start);
+        if (c == '"') wifiMgrChunkWrite(writer, "\\\"", 2);
+        else if (c == '\\') wifiMgrChunkWrite(writer, "\\\\", 2);
+        else if (c == '\n') wifiMgrChunkWrite(writer, "\\n", 2);
+        else if (c == '\r') wifiMgrChunkWrite(writer, "\\r", 2);
+        else if (c == '\t') wifiMgrChunkWrite(writer, "\\t", 2);
+        else wifiMgrChunkPrintf(writer, "\\u%04x", c);
+        start = value + 1;
+    }
+    wifiMgrChunkWrite(writer, start, value - start);
+    wifiMgrChunkWrite(writer, "\"", 1);
+}
+
+void wifiMgrJsonSkipSpace(WifiMgrJsonParser* parser) {
+    while (parser->pos < parser->end && (*parser->pos == ' ' || *parser->pos == '\t' || *parser->pos == '\n' || *parser->pos == '\r')) parser->pos++;
+}
+
+bool wifiMgrJsonExpect(WifiMgrJsonParser* parser, char c) {
+    wifiMgrJsonSkipSpace(parser);
+    if (parser->pos >= parser->end || *parser->pos != c) return false;
+    parser->pos++;
+    return true;
+}
+
+bool wifiMgrJsonLiteral(WifiMgrJsonParser* parser, const char* literal) {
+    size_t len = strlen(literal);
+    if ((size_t) (parser->end - parser->pos) < len || strncmp(parser->pos, literal, len) != 0) return false;
+    parser->pos += len;
+    return true;
+}
+
+int wifiMgrJsonHex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool wifiMgrJsonReadHex4(WifiMgrJsonParser* parser, uint32_t* out) {
+    if (parser->end - parser->pos < 4) return false;
+    *out = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        int digit = wifiMgrJsonHex(*parser->pos++);
+        if (digit < 0) return false;
+        *out = (*out << 4) | digit;
+    }
+    return true;
+}
+
+// decodes the string at the current position (after the opening quote) into buffer, NUL terminated
+bool wifiMgrJsonReadString(WifiMgrJsonParser* parser, char* buffer, size_t size, size_t* len) {
+    size_t out = 0;
+    while (parser->pos < parser->end) {
+        unsigned char c = *parser->pos++;
+        uint8_t utf8[4];
+        uint8_t utf8Len = 1;
+        if (c == '"') {
+            buffer[out] = 0;
+            if (len != nullptr) *len = out;
+            return true;
+        } else if (c < 0x20) {
+            return false;
+        } else if (c != '\\') {
+            utf8[0] = c;
+        } else {
+            if (parser->pos >= parser->end) return false;
+            c = *parser->pos++;
+            if (c == '"' || c == '\\' || c == '/') utf8[0] = c;
+            else if (c == 'b') utf8[0] = '\b';
+            else if (c == 'f') utf8[0] = '\f';
+            else if (c == 'n') utf8[0] = '\n';
+            else if (c == 'r') utf8[0] = '\r';
+            else if (c == 't') utf8[0] = '\t';
+            else if (c == 'u') {
+                uint32_t cp;
+                if (!wifiMgrJsonReadHex4(parser, &cp)) return false;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // surrogate pair
+                    uint32_t low;
+                    if (!wifiMgrJsonLiteral(parser, "\\u") || !wifiMgrJsonReadHex4(parser, &low) || low < 0xDC00 || low > 0xDFFF) return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return false;
+                }
+                if (cp == 0) return false; // would end the config value early
+                if (cp < 0x80) {
+                    utf8[0] = cp;
+                } else if (cp < 0x800) {
+                    utf8[0] = 0xC0 | (cp >> 6);
+                    utf8[1] = 0x80 | (cp & 0x3F);
+                    utf8Len = 2;
+                } else if (cp < 0x10000) {
+                    utf8[0] = 0xE0 | (cp >> 12);
+                    utf8[1] = 0x80 | ((cp >> 6) & 0x3F);
+                    utf8[2] = 0x80 | (cp & 0x3F);
+                    utf8Len = 3;
+                } else {
+                    utf8[0] = 0xF0 | (cp >> 18);
+                    utf8[1] = 0x80 | ((cp >> 12) & 0x3F);
+                    utf8[2] = 0x80 | ((cp >> 6) & 0x3F);
+                    utf8[3] = 0x80 | (cp & 0x3F);
+                    utf8Len = 4;
+                }
+            } else {
+                return false;
+            }
+        }
+        if (out + utf8Len >= size) return false;
+        memcpy(buffer + out, utf8, utf8Len);
+        out += utf8Len;
+    }
+    return false;
+}
+
+bool wifiMgrJsonBegin(WifiMgrJsonParser* parser, const char* json, size_t len) {
+    parser->pos = json;
+    parser->end = json + len;
+    parser->first = true;
+    return wifiMgrJsonExpect(parser, '{');
+}
+
+int wifiMgrJsonNextMember(WifiMgrJsonParser* parser, char* key, size_t keySize, WifiMgrJsonValue* value) {
+    wifiMgrJsonSkipSpace(parser);
+    if (parser->pos < parser->end && *parser->pos == '}') {
+        parser->pos++;
+        wifiMgrJsonSkipSpace(parser);
+        return parser->pos == parser->end ? 0 : -1;
+    }
+    if (!parser->first && !wifiMgrJsonExpect(parser, ',')) return -1;
+    parser->first = false;
+
+    if (!wifiMgrJsonExpect(parser, '"') || !wifiMgrJsonReadString(parser, key, keySize, nullptr)) return -1;
+    if (!wifiMgrJsonExpect(parser, ':')) return -1;
+    wifiMgrJsonSkipSpace(parser);
+    if (parser->pos >= parser->end) return -1;
+
+    char c = *parser->pos;
+    if (c == '"') {
+        parser->pos++;
+        value->type = WIFI_MGR_JSON_STRING;
+        if (!wifiMgrJsonReadString(parser, value->string, value->stringSize, &value->stringLen)) return -1;
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        // integers only, that is all a config entry can hold
+        bool negative = c == '-';
+        if (negative) parser->pos++;
+        unsigned long limit = (unsigned long) LONG_MAX + (negative ? 1 : 0);
+        unsigned long number = 0;
+        const char* digits = parser->pos;
+        while (parser->pos < parser->end && *parser->pos >= '0' && *parser->pos <= '9') {
+            unsigned long digit = *parser->pos++ - '0';
+            if (number > (limit - digit) / 10) return -1;
+            number = number * 10 + digit;
+        }
+        if (parser->pos == digits) return -1;
+        if (parser->pos < parser->end && (*parser->pos == '.' || *parser->pos == 'e' || *parser->pos == 'E')) return -1;
+        value->type = WIFI_MGR_JSON_NUMBER;
+        value->number = negative ? (long) (0 - number) : (long) number;
+    } else if (wifiMgrJsonLiteral(parser, "true")) {
+        value->type = WIFI_MGR_JSON_BOOL;
+        value->boolean = true;
+    } else if (wifiMgrJsonLiteral(parser, "false")) {
+        value->type = WIFI_MGR_JSON_BOOL;
+        value->boolean = false;
+    } else if (wifiMgrJsonLiteral(parser, "null")) {
+        value->type = WIFI_MGR_JSON_NULL;
+    } else {
+        return -1;
+    }
+    return 1;
+}
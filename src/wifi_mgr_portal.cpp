@@ -1,6 +1,10 @@
 // PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
 
 #include "wifi_mgr_portal.h"
+#include "wifi_mgr_assets.h"
+#include "wifi_mgr_json.h"
+#include "wifi_mgr_dns.h"
+#include "wifi_mgr_scan_cache.h"
 #include <vector>
 
 bool wifiMgrPortalIsSetup = false;
@@ -14,6 +18,38 @@ const char *ssidPrefix = nullptr;
 const char *password = nullptr;
 
 PortalConfigEntry *firstEntry = nullptr;
+// open addressing hash index over the entries by eepromKey, size is a power of two and at least twice the entry count
+PortalConfigEntry **entryIndex = nullptr;
+uint16_t entryIndexSize = 0;
+uint16_t entryCount = 0;
+
+PortalConfigEntry* wifiMgrPortalFindEntry(const char* key) {
+    if (entryIndex == nullptr) return nullptr;
+    uint32_t hash = wifiMgrConfigHash(key);
+    for (uint16_t i = hash & (entryIndexSize - 1); entryIndex[i] != nullptr; i = (i + 1) & (entryIndexSize - 1)) {
+        if (entryIndex[i]->keyHash == hash && strcmp(entryIndex[i]->eepromKey, key) == 0) return entryIndex[i];
+    }
+    return nullptr;
+}
+
+// changes that need a reconnect or restart are applied by wifiMgrPortalLoop(), not in the handler
+enum WifiMgrPortalApplyState {
+    WIFI_MGR_APPLY_IDLE = 0,
+    WIFI_MGR_APPLY_PENDING = 1, // waiting for the response to go out
+    WIFI_MGR_APPLY_CONNECTING = 2,
+    WIFI_MGR_APPLY_COMMITTING = 3,
+    WIFI_MGR_APPLY_SUCCEEDED = 4,
+    WIFI_MGR_APPLY_FAILED = 5,
+    WIFI_MGR_APPLY_RESTARTING = 6
+};
+const char* wifiMgrPortalApplyStateNames[] = {"idle", "pending", "connecting", "committing", "succeeded", "failed", "restarting"};
+WifiMgrPortalApplyState wifiMgrPortalApplyState = WIFI_MGR_APPLY_IDLE;
+unsigned long wifiMgrPortalApplySince = 0;
+bool wifiMgrPortalApplyWifiChange = false;
+bool wifiMgrPortalApplyRestart = false;
+bool wifiMgrPortalApplyKeepsAP = false;
+// how long the portal AP stays up after the station connected (if no restart follows)
+unsigned long wifiMgrPortalApGraceMs = 30000;
 
 // Storage for on-change listeners
 std::vector<WifiMgrPortalOnChangeCallback> onChangeListeners;
@@ -25,476 +61,472 @@ PortalConfigEntry* getLastEntry() {
     return tmp;
 }
 
-void wifiMgrPortalSendConfigure() {
-    PortalConfigEntry *tmp = firstEntry;
-    int changes = 0;
-    bool needRestart = false;
-    bool isWifi = false;
-    if (wifiMgrPortalWebServer->method() == HTTP_POST) {
-        while (tmp != nullptr) {
-            if (wifiMgrPortalWebServer->hasArg(tmp->eepromKey) && !wifiMgrPortalWebServer->arg(tmp->eepromKey).isEmpty()) {
-                String val = wifiMgrPortalWebServer->arg(tmp->eepromKey);
-                const char *currentVal = wifiMgrGetConfig(tmp->eepromKey);
-                // config item is in post
-                if ((currentVal == nullptr || strcmp(val.c_str(), currentVal)) && (!tmp->isPassword || !wifiMgrPortalWebServer->arg(tmp->eepromKey).isEmpty())) {
-                    // value changed
-                    if (strcmp(tmp->eepromKey, "SSID") == 0 || strcmp(tmp->eepromKey, "WIFI_PW") == 0 || strcmp(tmp->eepromKey, "HOST") == 0) {
-                        isWifi = true;
-                    }
-                    if (tmp->restartOnChange) needRestart = true;
-                    if (tmp->type == STRING) {
-                        wifiMgrSetConfig(tmp->eepromKey, wifiMgrPortalWebServer->arg(tmp->eepromKey).c_str());
-                    } else if (tmp->type == NUMBER) {
-                        wifiMgrSetLongConfig(tmp->eepromKey, wifiMgrPortalWebServer->arg(tmp->eepromKey).toInt());
-                    } else if (tmp->type == BOOL) {
-                        wifiMgrSetBoolConfig(tmp->eepromKey, wifiMgrPortalWebServer->arg(tmp->eepromKey) == "1");
-                    }
-                    changes++;
-                }
+void wifiMgrPortalSetApplyState(WifiMgrPortalApplyState state) {
+    wifiMgrPortalApplyState = state;
+    wifiMgrPortalApplySince = millis();
+}
+
+bool wifiMgrPortalIsApplying() {
+    return wifiMgrPortalApplyState == WIFI_MGR_APPLY_PENDING || wifiMgrPortalApplyState == WIFI_MGR_APPLY_CONNECTING || wifiMgrPortalApplyState == WIFI_MGR_APPLY_COMMITTING;
+}
+
+// queues a reconnect with the new credentials (committed once they work) and / or a restart
+void wifiMgrPortalQueueApply(bool wifiChange, bool restart) {
+    if (!wifiChange && !restart) return;
+    wifiMgrPortalApplyWifiChange = wifiChange;
+    wifiMgrPortalApplyRestart = restart;
+    wifiMgrPortalSetApplyState(wifiChange ? WIFI_MGR_APPLY_PENDING : WIFI_MGR_APPLY_RESTARTING);
+}
+
+// advances the queued job, called from wifiMgrPortalLoop()
+void wifiMgrPortalApplyLoop() {
+    unsigned long elapsed = millis() - wifiMgrPortalApplySince;
+    switch (wifiMgrPortalApplyState) {
+        case WIFI_MGR_APPLY_PENDING:
+            if (elapsed < 500) return;
+            // keep the portal AP reachable so the page can follow the progress
+            wifiMgrScanCacheStop();
+            wifiMgrPortalApplyKeepsAP = !wifiMgrPortalIsSetup;
+            wifiMgrSetKeepAP(wifiMgrPortalApplyKeepsAP);
+            // only the submitted network, a fallback connecting would not prove the new credentials
+            wifiMgrClearNetworks();
+            wifiMgrBeginWifi(wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("SSID")), wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("WIFI_PW")), wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("HOST")));
+            wifiMgrPortalSetApplyState(WIFI_MGR_APPLY_CONNECTING);
+            return;
+        case WIFI_MGR_APPLY_CONNECTING:
+            if (!wifiMgrPortalIsSetup) loopWifi();
+            if (wifiMgrGetConnectPhase() == WIFI_MGR_CONNECTED) {
+                wifiMgrPortalSetApplyState(WIFI_MGR_APPLY_COMMITTING);
+            } else if (wifiMgrGetConnectPhase() == WIFI_MGR_IDLE) {
+                wifiMgrPortalConnectFailed = true;
+                wifiMgrPortalSetApplyState(WIFI_MGR_APPLY_FAILED);
+                // drop the uncommitted credentials, the next commit or form must not see them
+                wifiMgrClearEEPROM();
+                wifiMgrLoadNetworksFromConfig();
+                // no retries with the new credentials, (re)open the portal instead
+                wifiMgrPortalIsSetup = false;
+                if (wifiMgrPortalApplyKeepsAP) return;
+                wifiMgrPortalStarted = false;
             }
-            tmp = tmp->next;
-        }
-        
-        // Notify all registered on-change listeners if there were any changes
-        if (changes > 0) {
-            for (const auto& listener : onChangeListeners) {
-                if (listener != nullptr) {
-                    listener(changes);
-                }
+            return;
+        case WIFI_MGR_APPLY_COMMITTING:
+            wifiMgrPortalCommitFailed = !wifiMgrCommitEEPROM();
+            wifiMgrLoadNetworksFromConfig();
+            wifiMgrPortalConnectFailed = false;
+            wifiMgrPortalIsSetup = true;
+            wifiMgrPortalSetApplyState(wifiMgrPortalApplyRestart ? WIFI_MGR_APPLY_RESTARTING : WIFI_MGR_APPLY_SUCCEEDED);
+            return;
+        case WIFI_MGR_APPLY_SUCCEEDED:
+            if (wifiMgrPortalApplyKeepsAP && elapsed > wifiMgrPortalApGraceMs) {
+                wifiMgrPortalApplyKeepsAP = false;
+                wifiMgrSetKeepAP(false);
+                wifiMgrDnsStop();
+                WiFi.softAPdisconnect(true);
+                wifiMgrPortalStarted = false;
             }
-        }
+            return;
+        case WIFI_MGR_APPLY_RESTARTING:
+            // leave time for the response and a last status poll
+            if (elapsed < (wifiMgrPortalApplyWifiChange ? 3000UL : 1000UL)) return;
+            wifiMgrPortalCleanup(); // Clean up resources before restart
+            ESP.restart();
+            return;
+        default:
+            return;
     }
-    
-    // Start building the HTML response with improved structure
-    String ret = "<!DOCTYPE html>\n<html lang=\"en\">\n<head>\n";
-    ret += "  <meta charset=\"UTF-8\">\n";
-    ret += "  <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n";
-    ret += "  <title>WiFi Manager</title>\n";
-    ret += "  <link rel=\"stylesheet\" href=\"/wifiMgr/style.css\">\n";
-    ret += "</head>\n<body>\n";
-    ret += "  <div class=\"container\">\n";
-    ret += "    <h1>WiFi Manager</h1>\n";
-    
+}
+
+// GET /wifiMgr/api/networks: cached result of the background scan, never starts a scan itself
+void wifiMgrPortalApiNetworks() {
+    WifiMgrChunkWriter writer;
+    wifiMgrChunkBegin(&writer, wifiMgrPortalWebServer, 200, "application/json");
+    wifiMgrScanCacheWriteJson(&writer);
+    wifiMgrChunkEnd(&writer);
+}
+
+// GET /wifiMgr/api/apply-status
+void wifiMgrPortalApiApplyStatus() {
+    WifiMgrChunkWriter writer;
+    wifiMgrChunkBegin(&writer, wifiMgrPortalWebServer, 200, "application/json");
+    wifiMgrChunkPrintf(&writer, "{\"state\":\"%s\",\"elapsed\":%lu,\"phase\":\"%s\",\"ssid\":", wifiMgrPortalApplyStateNames[wifiMgrPortalApplyState],
+                       millis() - wifiMgrPortalApplySince, wifiMgrGetConnectPhaseName());
+    wifiMgrJsonWriteString(&writer, wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("SSID")));
+    wifiMgrChunkPrintf(&writer, ",\"ip\":\"%s\",\"commitFailed\":%s,\"restart\":%s}", WiFi.localIP().toString().c_str(),
+                       wifiMgrPortalCommitFailed ? "true" : "false", wifiMgrPortalApplyRestart ? "true" : "false");
+    wifiMgrChunkEnd(&writer);
+}
+
+// escapes the characters that would end an attribute value or start a tag
+void wifiMgrPortalWriteEscaped(WifiMgrChunkWriter* writer, const char* value) {
+    if (value == nullptr) return;
+    const char* start = value;
+    for (; *value != 0; value++) {
+        const char* entity;
+        if (*value == '&') entity = "&amp;";
+        else if (*value == '<') entity = "&lt;";
+        else if (*value == '>') entity = "&gt;";
+        else if (*value == '"') entity = "&quot;";
+        else if (*value == '\'') entity = "&#39;";
+        else continue;
+        wifiMgrChunkWrite(writer, start, value - start);
+        wifiMgrChunkWrite(writer, entity);
+        start = value + 1;
+    }
+    wifiMgrChunkWrite(writer, start, value - start);
+}
+
+// streams the page in small chunks so the heap needed does not grow with the number of entries
+void wifiMgrPortalSendPage(int changes, bool needRestart) {
+    WifiMgrChunkWriter writer;
+    wifiMgrChunkBegin(&writer, wifiMgrPortalWebServer, 200, "text/html");
+    wifiMgrChunkWrite(&writer, "<!DOCTYPE html>\n<html lang=\"en\">\n<head>\n"
+                               "  <meta charset=\"UTF-8\">\n"
+                               "  <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
+                               "  <title>WiFi Manager</title>\n"
+                               "  <link rel=\"stylesheet\" href=\"/wifiMgr/style.css?v=" WIFI_MGR_ASSET_STYLE_CSS_ETAG "\">\n"
+                               "</head>\n<body>\n"
+                               "  <div class=\"container\">\n"
+                               "    <h1>WiFi Manager</h1>\n");
+
     // Add status messages if needed
-    if (changes > 0 || needRestart || wifiMgrPortalConnectFailed || wifiMgrPortalCommitFailed) {
-        if (changes > 0) {
-            ret += "    <div class=\"message success\">" + String(changes) + " changes made successfully.</div>\n";
-        }
-        if (needRestart) {
-            ret += "    <div class=\"message info\">Device will restart now.</div>\n";
-        }
-        if (wifiMgrPortalConnectFailed) {
-            ret += "    <div class=\"message error\">Failed to connect to WiFi. Please check your credentials.</div>\n";
-        }
-        if (wifiMgrPortalCommitFailed) {
-            ret += "    <div class=\"message error\">Failed to save settings to EEPROM.</div>\n";
-        }
+    if (changes > 0) {
+        wifiMgrChunkPrintf(&writer, "    <div class=\"message success\">%d changes made successfully.</div>\n", changes);
     }
-    
+    if (wifiMgrPortalIsApplying()) {
+        // script.js polls /wifiMgr/api/apply-status and updates this
+        wifiMgrChunkWrite(&writer, "    <div class=\"message info\" id=\"apply-status\">Applying WiFi settings...</div>\n");
+    } else if (needRestart) {
+        wifiMgrChunkWrite(&writer, "    <div class=\"message info\">Device will restart now.</div>\n");
+    }
+    if (wifiMgrPortalConnectFailed) {
+        wifiMgrChunkWrite(&writer, "    <div class=\"message error\">Failed to connect to WiFi. Please check your credentials.</div>\n");
+    }
+    if (wifiMgrPortalCommitFailed) {
+        wifiMgrChunkWrite(&writer, "    <div class=\"message error\">Failed to save settings to EEPROM.</div>\n");
+    }
+
     // Start the form
-    ret += "    <form action=\"#\" method=\"POST\" onsubmit=\"return validateForm(this)\">\n";
-    
+    wifiMgrChunkWrite(&writer, "    <form action=\"#\" method=\"POST\" onsubmit=\"return validateForm(this)\">\n");
+
     // Add form fields
-    tmp = firstEntry;
+    PortalConfigEntry *tmp = firstEntry;
     while (tmp != nullptr) {
-        ret += "      <div class=\"form-group\">\n";
-        ret += "        <h2>" + String(tmp->name) + "</h2>\n";
-        
-        if (tmp->type == STRING) {
-            ret += "        <input type=\"" + String(tmp->isPassword ? "password" : "text") + "\" ";
-            ret += "name=\"" + String(tmp->eepromKey) + "\" ";
+        wifiMgrChunkWrite(&writer, "      <div class=\"form-group\">\n        <h2>");
+        wifiMgrPortalWriteEscaped(&writer, tmp->name);
+        wifiMgrChunkWrite(&writer, "</h2>\n");
+
+        if (tmp->type == STRING || tmp->type == NUMBER) {
+            if (tmp->type == NUMBER) wifiMgrChunkWrite(&writer, "        <input type=\"number\" name=\"");
+            else if (tmp->isPassword) wifiMgrChunkWrite(&writer, "        <input type=\"password\" name=\"");
+            else wifiMgrChunkWrite(&writer, "        <input type=\"text\" name=\"");
+            wifiMgrPortalWriteEscaped(&writer, tmp->eepromKey);
+            wifiMgrChunkWrite(&writer, "\" ");
             if (!tmp->isPassword) {
-                ret += "value=\"" + String(wifiMgrGetConfig(tmp->eepromKey)) + "\" ";
+                wifiMgrChunkWrite(&writer, "value=\"");
+                wifiMgrPortalWriteEscaped(&writer, wifiMgrGetConfig(tmp->eepromKey, tmp->keyHash));
+                wifiMgrChunkWrite(&writer, "\" ");
             }
-            if (strcmp(tmp->eepromKey, "SSID") == 0) {
-                ret += "required ";
+            if (tmp->type == STRING && strcmp(tmp->eepromKey, "SSID") == 0) {
+                wifiMgrChunkWrite(&writer, "required ");
             }
-            ret += ">\n";
-        } else if (tmp->type == NUMBER) {
-            ret += "        <input type=\"number\" name=\"" + String(tmp->eepromKey) + "\" ";
-            if (!tmp->isPassword) {
-                ret += "value=\"" + String(wifiMgrGetConfig(tmp->eepromKey)) + "\" ";
+            if (tmp->type == STRING && strncmp(tmp->eepromKey, "SSID", 4) == 0) {
+                // filled by script.js from /wifiMgr/api/networks
+                wifiMgrChunkWrite(&writer, "list=\"wifiMgrNetworks\" autocomplete=\"off\" ");
             }
-            ret += ">\n";
+            wifiMgrChunkWrite(&writer, ">\n");
         } else if (tmp->type == BOOL) {
-            ret += "        <select name=\"" + String(tmp->eepromKey) + "\">\n";
-            ret += "          <option value=\"1\"";
-            if (wifiMgrGetBoolConfig(tmp->eepromKey, false)) ret += " selected";
-            ret += ">Yes / On</option>\n";
-            ret += "          <option value=\"0\"";
-            if (!wifiMgrGetBoolConfig(tmp->eepromKey, true)) ret += " selected";
-            ret += ">No / Off</option>\n";
-            ret += "        </select>\n";
+            wifiMgrChunkWrite(&writer, "        <select name=\"");
+            wifiMgrPortalWriteEscaped(&writer, tmp->eepromKey);
+            wifiMgrChunkWrite(&writer, "\">\n          <option value=\"1\"");
+            if (wifiMgrGetBoolConfig(tmp->eepromKey, tmp->keyHash, false)) wifiMgrChunkWrite(&writer, " selected");
+            wifiMgrChunkWrite(&writer, ">Yes / On</option>\n          <option value=\"0\"");
+            if (!wifiMgrGetBoolConfig(tmp->eepromKey, tmp->keyHash, true)) wifiMgrChunkWrite(&writer, " selected");
+            wifiMgrChunkWrite(&writer, ">No / Off</option>\n        </select>\n");
         }
-        
-        ret += "      </div>\n";
+
+        wifiMgrChunkWrite(&writer, "      </div>\n");
         tmp = tmp->next;
     }
-    
-    // Add submit button
-    ret += "      <input type=\"submit\" value=\"Save Settings\">\n";
-    ret += "    </form>\n";
-    ret += "  </div>\n";
-    
-    // Add footer
-    ret += "  <footer>WiFi Manager Portal - ESP WiFi Configuration</footer>\n";
-    
-    // Add JavaScript
-    ret += "  <script src=\"/wifiMgr/script.js\"></script>\n";
-    ret += "</body>\n</html>";
-
-    if (wifiMgrPortalWebServer->method() == HTTP_POST) {
-        if (isWifi) {
-            wifiMgrPortalWebServer->send(200, "text/html", ret);
-            unsigned long start = millis();
-            while (millis() - start < 500) yield();
-            setupWifi(wifiMgrGetConfig("SSID"), wifiMgrGetConfig("WIFI_PW"));
-            if (WiFi.isConnected()) {
-                if (!wifiMgrCommitEEPROM()) {
-                    wifiMgrPortalCommitFailed = true;
-                }
-                wifiMgrPortalConnectFailed = false;
-            } else {
-                wifiMgrPortalIsSetup = false;
-                wifiMgrPortalStarted = false;
-                wifiMgrPortalConnectFailed = true;
-                wifiMgrPortalLoop();
-                return;
-            }
-        } else {
-            if (!wifiMgrCommitEEPROM()) {
-                wifiMgrPortalCommitFailed = true;
-                wifiMgrPortalWebServer->send(200, "text/html", ret);
-            } else {
-                wifiMgrPortalWebServer->send(200, "text/html", ret);
+
+    wifiMgrChunkWrite(&writer, "      <datalist id=\"wifiMgrNetworks\"></datalist>\n"
+                               "      <input type=\"submit\" value=\"Save Settings\">\n"
+                               "    </form>\n"
+                               "  </div>\n"
+                               "  <footer>WiFi Manager Portal - ESP WiFi Configuration</footer>\n"
+                               "  <script src=\"/wifiMgr/script.js?v=" WIFI_MGR_ASSET_SCRIPT_JS_ETAG "\"></script>\n"
+                               "</body>\n</html>");
+    wifiMgrChunkEnd(&writer);
+}
+
+bool wifiMgrPortalIsWifiKey(const char* key) {
+    return strncmp(key, "SSID", 4) == 0 || strncmp(key, "WIFI_PW", 7) == 0 || strcmp(key, "HOST") == 0;
+}
+
+void wifiMgrPortalNotifyListeners(int changes) {
+    for (const auto& listener : onChangeListeners) {
+        if (listener != nullptr) {
+            listener(changes);
+        }
+    }
+}
+
+// stores the posted values of either the wifi keys or all others, returns the number of changes
+int wifiMgrPortalStoreArgs(bool wifiKeys, bool* needRestart) {
+    int changes = 0;
+    for (PortalConfigEntry *tmp = firstEntry; tmp != nullptr; tmp = tmp->next) {
+        if (tmp->argIndex < 0 || wifiMgrPortalIsWifiKey(tmp->eepromKey) != wifiKeys) continue;
+        // a reference on ESP8266, the ESP32 core only hands out copies
+        const String& val = wifiMgrPortalWebServer->arg(tmp->argIndex);
+        const char *currentVal = wifiMgrGetConfig(tmp->eepromKey, tmp->keyHash);
+        // config item is in post. Text fields are pre-filled, so an empty one was cleared (e.g. the static IP
+        // to go back to DHCP), while empty password and number fields are left as they are
+        if (val.isEmpty() && (tmp->isPassword || tmp->type != STRING)) continue;
+        if (currentVal == nullptr ? !val.isEmpty() : strcmp(val.c_str(), currentVal) != 0) {
+            // value changed
+            if (tmp->restartOnChange) *needRestart = true;
+            if (tmp->type == STRING) {
+                wifiMgrSetConfig(tmp->eepromKey, val.c_str());
+            } else if (tmp->type == NUMBER) {
+                wifiMgrSetLongConfig(tmp->eepromKey, val.toInt());
+            } else if (tmp->type == BOOL) {
+                wifiMgrSetBoolConfig(tmp->eepromKey, val == "1");
             }
+            changes++;
         }
-        if (needRestart) {
-            unsigned long start = millis();
-            while (millis() - start < 1000) yield();
-            wifiMgrPortalCleanup(); // Clean up resources before restart
-            ESP.restart();
+    }
+    return changes;
+}
+
+void wifiMgrPortalSendConfigure() {
+    PortalConfigEntry *tmp = firstEntry;
+    int changes = 0;
+    bool needRestart = false;
+    bool isWifi = false;
+    // a running apply would get its credentials committed by the next change, so the form only shows its progress
+    if (wifiMgrPortalWebServer->method() == HTTP_POST && !wifiMgrPortalIsApplying()) {
+        // one pass over the arguments to find the entries they belong to
+        for (tmp = firstEntry; tmp != nullptr; tmp = tmp->next) tmp->argIndex = -1;
+        for (int i = 0; i < wifiMgrPortalWebServer->args(); i++) {
+            PortalConfigEntry *entry = wifiMgrPortalFindEntry(wifiMgrPortalWebServer->argName(i).c_str());
+            if (entry != nullptr && entry->argIndex < 0) entry->argIndex = i;
+        }
+        changes = wifiMgrPortalStoreArgs(false, &needRestart);
+        // wifi changes are only committed once the new credentials work, so everything else is committed
+        // before them and a failed apply can simply reload the image
+        if (!wifiMgrCommitEEPROM()) {
+            wifiMgrPortalCommitFailed = true;
         }
+        int wifiChanges = wifiMgrPortalStoreArgs(true, &needRestart);
+        isWifi = wifiChanges > 0;
+        changes += wifiChanges;
+        
+        // Notify all registered on-change listeners if there were any changes
+        if (changes > 0) {
+            wifiMgrPortalNotifyListeners(changes);
+        }
+    }
+    
+    if (wifiMgrPortalWebServer->method() == HTTP_POST && !wifiMgrPortalIsApplying()) {
+        wifiMgrPortalQueueApply(isWifi, needRestart);
+        wifiMgrPortalSendPage(changes, needRestart);
     } else {
-        wifiMgrPortalWebServer->send(200, "text/html", ret);
+        wifiMgrPortalSendPage(changes, needRestart);
     }
 }
 
-// CSS content handler
-void handleCSS() {
-    String css = R"(
-/* WiFi Manager Portal Styles */
-:root {
-  --primary-color: #2196F3;
-  --primary-dark: #1976D2;
-  --secondary-color: #FF9800;
-  --text-color: #333333;
-  --light-bg: #f5f5f5;
-  --border-color: #dddddd;
-  --success-color: #4CAF50;
-  --error-color: #F44336;
-}
+const char* wifiMgrPortalTypeNames[] = {"string", "number", "bool"};
 
-* {
-  box-sizing: border-box;
-  margin: 0;
-  padding: 0;
+// GET /wifiMgr/api/config: schema and current values, passwords are only reported as set or not
+void wifiMgrPortalApiGetConfig() {
+    WifiMgrChunkWriter writer;
+    wifiMgrChunkBegin(&writer, wifiMgrPortalWebServer, 200, "application/json");
+    wifiMgrChunkWrite(&writer, "{\"entries\":[");
+    PortalConfigEntry *tmp = firstEntry;
+    while (tmp != nullptr) {
+        wifiMgrChunkWrite(&writer, tmp == firstEntry ? "{\"key\":" : ",{\"key\":");
+        wifiMgrJsonWriteString(&writer, tmp->eepromKey);
+        wifiMgrChunkWrite(&writer, ",\"name\":");
+        wifiMgrJsonWriteString(&writer, tmp->name);
+        wifiMgrChunkPrintf(&writer, ",\"type\":\"%s\",\"password\":%s,\"restart\":%s,", wifiMgrPortalTypeNames[tmp->type],
+                           tmp->isPassword ? "true" : "false", tmp->restartOnChange ? "true" : "false");
+        const char* value = wifiMgrGetConfig(tmp->eepromKey, tmp->keyHash);
+        if (tmp->isPassword) {
+            wifiMgrChunkPrintf(&writer, "\"set\":%s}", value != nullptr && value[0] != 0 ? "true" : "false");
+        } else if (value == nullptr) {
+            wifiMgrChunkWrite(&writer, "\"value\":null}");
+        } else if (tmp->type == NUMBER) {
+            wifiMgrChunkPrintf(&writer, "\"value\":%ld}", wifiMgrGetLongConfig(tmp->eepromKey, tmp->keyHash, 0));
+        } else if (tmp->type == BOOL) {
+            wifiMgrChunkPrintf(&writer, "\"value\":%s}", wifiMgrGetBoolConfig(tmp->eepromKey, tmp->keyHash, false) ? "true" : "false");
+        } else {
+            wifiMgrChunkWrite(&writer, "\"value\":");
+            wifiMgrJsonWriteString(&writer, value);
+            wifiMgrChunkWrite(&writer, "}");
+        }
+        tmp = tmp->next;
+    }
+    wifiMgrChunkWrite(&writer, "]}");
+    wifiMgrChunkEnd(&writer);
 }
 
-body {
-  font-family: 'Arial', sans-serif;
-  line-height: 1.6;
-  color: var(--text-color);
-  background-color: var(--light-bg);
-  padding: 20px;
-  max-width: 800px;
-  margin: 0 auto;
+void wifiMgrPortalApiError(const char* error, const char* key) {
+    WifiMgrChunkWriter writer;
+    wifiMgrChunkBegin(&writer, wifiMgrPortalWebServer, 400, "application/json");
+    wifiMgrChunkWrite(&writer, "{\"error\":");
+    wifiMgrJsonWriteString(&writer, error);
+    if (key != nullptr) {
+        wifiMgrChunkWrite(&writer, ",\"key\":");
+        wifiMgrJsonWriteString(&writer, key);
+    }
+    wifiMgrChunkWrite(&writer, "}");
+    wifiMgrChunkEnd(&writer);
 }
 
-.container {
-  background-color: white;
-  border-radius: 8px;
-  box-shadow: 0 2px 10px rgba(0, 0, 0, 0.1);
-  padding: 20px;
-  margin-bottom: 20px;
+// null leaves an entry unchanged, as does an empty password (like in the form)
+bool wifiMgrPortalApiIsNoop(PortalConfigEntry* entry, const WifiMgrJsonValue* value) {
+    return value->type == WIFI_MGR_JSON_NULL || (entry->isPassword && value->type == WIFI_MGR_JSON_STRING && value->stringLen == 0);
 }
 
-h1 {
-  color: var(--primary-color);
-  margin-bottom: 20px;
-  text-align: center;
-}
-
-h2 {
-  color: var(--primary-dark);
-  margin: 15px 0 10px 0;
-  font-size: 1.2rem;
-  border-bottom: 1px solid var(--border-color);
-  padding-bottom: 5px;
-}
-
-.form-group {
-  margin-bottom: 15px;
-}
-
-label {
-  display: block;
-  margin-bottom: 5px;
-  font-weight: bold;
-}
-
-input[type="text"],
-input[type="password"],
-input[type="number"],
-select {
-  width: 100%;
-  padding: 10px;
-  border: 1px solid var(--border-color);
-  border-radius: 4px;
-  font-size: 16px;
-}
-
-input[type="text"]:focus,
-input[type="password"]:focus,
-input[type="number"]:focus,
-select:focus {
-  outline: none;
-  border-color: var(--primary-color);
-  box-shadow: 0 0 0 2px rgba(33, 150, 243, 0.2);
-}
-
-button, 
-input[type="submit"] {
-  background-color: var(--primary-color);
-  color: white;
-  border: none;
-  padding: 10px 15px;
-  border-radius: 4px;
-  cursor: pointer;
-  font-size: 16px;
-  display: block;
-  width: 100%;
-  margin-top: 20px;
-  transition: background-color 0.3s;
-}
-
-button:hover,
-input[type="submit"]:hover {
-  background-color: var(--primary-dark);
-}
-
-.message {
-  padding: 10px;
-  margin: 15px 0;
-  border-radius: 4px;
+bool wifiMgrPortalApiIsValid(PortalConfigEntry* entry, const WifiMgrJsonValue* value) {
+    if (wifiMgrPortalApiIsNoop(entry, value)) return true;
+    if (entry->type == STRING) return value->type == WIFI_MGR_JSON_STRING;
+    if (entry->type == NUMBER) return value->type == WIFI_MGR_JSON_NUMBER;
+    return value->type == WIFI_MGR_JSON_BOOL;
 }
 
-.success {
-  background-color: rgba(76, 175, 80, 0.1);
-  border: 1px solid var(--success-color);
-  color: var(--success-color);
+// returns true if the stored value changed
+bool wifiMgrPortalApiApply(PortalConfigEntry* entry, const WifiMgrJsonValue* value) {
+    if (wifiMgrPortalApiIsNoop(entry, value)) return false;
+    if (entry->type == STRING) {
+        const char* current = wifiMgrGetConfig(entry->eepromKey, entry->keyHash);
+        if (current != nullptr && strcmp(current, value->string) == 0) return false;
+        wifiMgrSetConfig(entry->eepromKey, value->string);
+    } else if (entry->type == NUMBER) {
+        // ~number can never be equal to number, so a missing entry always counts as change
+        if (wifiMgrGetLongConfig(entry->eepromKey, entry->keyHash, ~value->number) == value->number) return false;
+        wifiMgrSetLongConfig(entry->eepromKey, value->number);
+    } else {
+        if (wifiMgrGetBoolConfig(entry->eepromKey, entry->keyHash, !value->boolean) == value->boolean) return false;
+        wifiMgrSetBoolConfig(entry->eepromKey, value->boolean);
+    }
+    return true;
 }
 
-.error {
-  background-color: rgba(244, 67, 54, 0.1);
-  border: 1px solid var(--error-color);
-  color: var(--error-color);
+// POST / PATCH /wifiMgr/api/config with a flat object of key: value. Either all values are applied
+// (followed by one commit and one notification) or, if anything is invalid, none
+void wifiMgrPortalApiSetConfig() {
+    const String& body = wifiMgrPortalWebServer->arg("plain");
+    char key[64];
+    char string[256];
+    WifiMgrJsonValue value;
+    value.string = string;
+    value.stringSize = sizeof(string);
+    WifiMgrJsonParser parser;
+    int changes = 0;
+    bool needRestart = false;
+    bool isWifi = false;
+    bool committed = false;
+    if (wifiMgrPortalIsApplying()) {
+        wifiMgrPortalApiError("apply in progress", nullptr);
+        return;
+    }
+
+    // the first pass only validates, the second one applies everything but the wifi keys, the third one those.
+    // wifi changes are only committed once the new credentials work, so a failed apply can reload the image
+    for (uint8_t pass = 0; pass < 3; pass++) {
+        if (pass == 2 && changes > 0) {
+            committed = wifiMgrCommitEEPROM();
+            if (!committed) wifiMgrPortalCommitFailed = true;
+        }
+        if (!wifiMgrJsonBegin(&parser, body.c_str(), body.length())) {
+            wifiMgrPortalApiError("expected a JSON object", nullptr);
+            return;
+        }
+        int next;
+        while ((next = wifiMgrJsonNextMember(&parser, key, sizeof(key), &value)) == 1) {
+            PortalConfigEntry* entry = wifiMgrPortalFindEntry(key);
+            if (entry == nullptr) {
+                wifiMgrPortalApiError("unknown key", key);
+                return;
+            }
+            if (!wifiMgrPortalApiIsValid(entry, &value)) {
+                wifiMgrPortalApiError("invalid value type", key);
+                return;
+            }
+            if (pass > 0 && wifiMgrPortalIsWifiKey(entry->eepromKey) == (pass == 2) && wifiMgrPortalApiApply(entry, &value)) {
+                if (pass == 2) isWifi = true;
+                if (entry->restartOnChange) needRestart = true;
+                changes++;
+            }
+        }
+        if (next < 0) {
+            wifiMgrPortalApiError("invalid or unsupported JSON", nullptr);
+            return;
+        }
+    }
+
+    if (changes > 0) wifiMgrPortalNotifyListeners(changes);
+    wifiMgrPortalQueueApply(isWifi, needRestart);
+    char response[128];
+    snprintf(response, sizeof(response), "{\"changes\":%d,\"committed\":%s,\"wifi\":%s,\"restart\":%s,\"apply\":\"%s\"}", changes,
+             committed ? "true" : "false", isWifi ? "true" : "false", needRestart ? "true" : "false", wifiMgrPortalApplyStateNames[wifiMgrPortalApplyState]);
+    wifiMgrPortalWebServer->send(200, "application/json", response);
 }
 
-.info {
-  background-color: rgba(33, 150, 243, 0.1);
-  border: 1px solid var(--primary-color);
-  color: var(--primary-color);
+// sends a pre-gzipped asset straight from flash, or only a 304 if the client has this version cached.
+// The asset urls carry the content hash, so the client may keep them for a year without revalidating.
+void wifiMgrPortalSendAsset(const char* contentType, const char* etag, const uint8_t* data, size_t len) {
+    wifiMgrPortalWebServer->sendHeader("ETag", etag);
+    wifiMgrPortalWebServer->sendHeader("Cache-Control", "public, max-age=31536000, immutable");
+    if (wifiMgrPortalWebServer->hasHeader("If-None-Match") && wifiMgrPortalWebServer->header("If-None-Match") == etag) {
+        wifiMgrPortalWebServer->send(304);
+        return;
+    }
+    wifiMgrPortalWebServer->sendHeader("Vary", "Accept-Encoding");
+    wifiMgrPortalWebServer->sendHeader("Content-Encoding", "gzip");
+    wifiMgrPortalWebServer->send_P(200, contentType, (PGM_P) data, len);
 }
 
-footer {
-  text-align: center;
-  margin-top: 20px;
-  font-size: 0.8rem;
-  color: #666;
+// CSS content handler, source in web/style.css
+void handleCSS() {
+    wifiMgrPortalSendAsset("text/css", "\"" WIFI_MGR_ASSET_STYLE_CSS_ETAG "\"", wifiMgrAssetStyleCss, sizeof(wifiMgrAssetStyleCss));
 }
 
-@media (max-width: 600px) {
-  body {
-    padding: 10px;
-  }
-  
-  .container {
-    padding: 15px;
-  }
-  
-  h1 {
-    font-size: 1.5rem;
-  }
-  
-  h2 {
-    font-size: 1.1rem;
-  }
+// JavaScript content handler, source in web/script.js
+void handleJS() {
+    wifiMgrPortalSendAsset("application/javascript", "\"" WIFI_MGR_ASSET_SCRIPT_JS_ETAG "\"", wifiMgrAssetScriptJs, sizeof(wifiMgrAssetScriptJs));
 }
-)";
-    wifiMgrPortalWebServer->send(200, "text/css", css);
+
+void wifiMgrPortalRedirect(const String& location) {
+    wifiMgrPortalWebServer->sendHeader("Location", location, true);
+    wifiMgrPortalWebServer->sendHeader("Cache-Control", "no-store");
+    wifiMgrPortalWebServer->send(302, "text/plain", "");
 }
 
-// JavaScript content handler
-void handleJS() {
-    String js = R"(
-// WiFi Manager Portal JavaScript
-document.addEventListener('DOMContentLoaded', function() {
-  // Add form submission handling
-  const form = document.querySelector('form');
-  if (form) {
-    form.addEventListener('submit', function(e) {
-      // Show loading message
-      const submitBtn = form.querySelector('input[type="submit"]');
-      if (submitBtn) {
-        const originalText = submitBtn.value || 'Submit';
-        submitBtn.value = 'Saving...';
-        submitBtn.disabled = true;
-        
-        // Re-enable after submission (for cases where page doesn't reload)
-        setTimeout(() => {
-          submitBtn.value = originalText;
-          submitBtn.disabled = false;
-        }, 5000);
-      }
-    });
-  }
-
-  // Add password visibility toggle
-  const passwordInputs = document.querySelectorAll('input[type="password"]');
-  passwordInputs.forEach(input => {
-    // Create toggle button
-    const toggleBtn = document.createElement('button');
-    toggleBtn.type = 'button';
-    toggleBtn.className = 'password-toggle';
-    toggleBtn.textContent = 'Show';
-    toggleBtn.style.position = 'absolute';
-    toggleBtn.style.right = '10px';
-    toggleBtn.style.top = '50%';
-    toggleBtn.style.transform = 'translateY(-50%)';
-    toggleBtn.style.background = 'none';
-    toggleBtn.style.border = 'none';
-    toggleBtn.style.color = '#2196F3';
-    toggleBtn.style.cursor = 'pointer';
-    toggleBtn.style.fontSize = '14px';
-    
-    // Create wrapper for positioning
-    const wrapper = document.createElement('div');
-    wrapper.style.position = 'relative';
-    
-    // Insert wrapper and move input inside
-    input.parentNode.insertBefore(wrapper, input);
-    wrapper.appendChild(input);
-    wrapper.appendChild(toggleBtn);
-    
-    // Add toggle functionality
-    toggleBtn.addEventListener('click', function() {
-      if (input.type === 'password') {
-        input.type = 'text';
-        toggleBtn.textContent = 'Hide';
-      } else {
-        input.type = 'password';
-        toggleBtn.textContent = 'Show';
-      }
-    });
-  });
-
-  // Add validation for form fields
-  const inputs = document.querySelectorAll('input[type="text"], input[type="password"], input[type="number"]');
-  inputs.forEach(input => {
-    input.addEventListener('blur', function() {
-      validateInput(input);
-    });
-  });
-
-  // Add message auto-hide
-  const messages = document.querySelectorAll('.message');
-  if (messages.length > 0) {
-    setTimeout(() => {
-      messages.forEach(msg => {
-        msg.style.opacity = '0';
-        msg.style.transition = 'opacity 0.5s ease';
-        setTimeout(() => {
-          msg.style.display = 'none';
-        }, 500);
-      });
-    }, 5000);
-  }
-});
-
-// Input validation function
-function validateInput(input) {
-  // Clear previous validation
-  const existingError = input.parentNode.querySelector('.validation-error');
-  if (existingError) {
-    existingError.remove();
-  }
-  
-  // Skip validation for empty optional fields
-  if (!input.value && !input.hasAttribute('required')) {
-    return true;
-  }
-  
-  let isValid = true;
-  let errorMessage = '';
-  
-  // Validate based on input type or name
-  if (input.name === 'SSID' && input.value.length < 1) {
-    isValid = false;
-    errorMessage = 'SSID is required';
-  } else if (input.name === 'HOST' && input.value.length > 0) {
-    // Hostname validation (letters, numbers, hyphens, no spaces)
-    const hostnameRegex = /^[a-zA-Z0-9-]+$/;
-    if (!hostnameRegex.test(input.value)) {
-      isValid = false;
-      errorMessage = 'Hostname can only contain letters, numbers, and hyphens';
-    }
-  } else if (input.type === 'number') {
-    const min = input.getAttribute('min');
-    const max = input.getAttribute('max');
-    
-    if (min !== null && parseInt(input.value) < parseInt(min)) {
-      isValid = false;
-      errorMessage = `Value must be at least ${min}`;
-    } else if (max !== null && parseInt(input.value) > parseInt(max)) {
-      isValid = false;
-      errorMessage = `Value must be at most ${max}`;
-    }
-  }
-  
-  // Display error if validation failed
-  if (!isValid) {
-    const errorElement = document.createElement('div');
-    errorElement.className = 'validation-error';
-    errorElement.style.color = '#F44336';
-    errorElement.style.fontSize = '12px';
-    errorElement.style.marginTop = '5px';
-    errorElement.textContent = errorMessage;
-    
-    input.parentNode.appendChild(errorElement);
-    input.style.borderColor = '#F44336';
-  } else {
-    input.style.borderColor = '';
-  }
-  
-  return isValid;
+// connectivity checks of the phone and desktop OSes: anything but the expected answer opens the portal.
+// The host is whatever the check asked for, so redirect to the address of the AP
+void handleCaptiveCheck() {
+    wifiMgrPortalRedirect("http://" + WiFi.softAPIP().toString() + "/wifiMgr/configure");
 }
 
-// Form validation before submission
-function validateForm(form) {
-  const inputs = form.querySelectorAll('input[type="text"], input[type="password"], input[type="number"]');
-  let isValid = true;
-  
-  inputs.forEach(input => {
-    if (!validateInput(input)) {
-      isValid = false;
-    }
-  });
-  
-  return isValid;
+void handleIndex() {
+    wifiMgrPortalRedirect("/wifiMgr/configure");
 }
-)";
-    wifiMgrPortalWebServer->send(200, "application/javascript", js);
+
+// static address from WM_IP / WM_GW / WM_MASK / WM_DNS, DHCP if WM_IP is not set
+void wifiMgrPortalApplyIPConfig() {
+    IPAddress ip((uint32_t) 0), gateway((uint32_t) 0), subnet((uint32_t) 0), dns((uint32_t) 0);
+    const char* value = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("WM_IP"));
+    if (value != nullptr && ip.fromString(value)) {
+        value = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("WM_GW"));
+        if (value != nullptr) gateway.fromString(value);
+        value = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("WM_MASK"));
+        if (value == nullptr || !subnet.fromString(value)) subnet = IPAddress(255, 255, 255, 0);
+        value = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("WM_DNS"));
+        if (value == nullptr || !dns.fromString(value)) dns = gateway;
+    }
+    wifiMgrSetStaticIP(ip, gateway, subnet, dns);
+    wifiMgrSetReuseLease(wifiMgrGetBoolConfig(WIFI_MGR_CONFIG_KEY("WM_LEASE"), false));
 }
 
 void wifiMgrPortalSetup(bool redirectIndex, const char* ssidPrefix_, const char* password_) {
@@ -512,14 +544,17 @@ void wifiMgrPortalSetup(bool redirectIndex, const char* ssidPrefix_, const char*
     ssidPrefix = (ssidPrefix_ != nullptr && strlen(ssidPrefix_) > 0) ? strdup(ssidPrefix_) : nullptr;
     password = (password_ != nullptr && strlen(password_) > 0) ? strdup(password_) : nullptr;
     wifiMgrPortalRedirectIndex = redirectIndex;
-    const char* ssid = wifiMgrGetConfig("SSID");
+    const char* ssid = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("SSID"));
     wifiMgrPortalAddConfigEntry("SSID", "SSID", STRING, false, true);
-    const char* pw = wifiMgrGetConfig("WIFI_PW");
+    const char* pw = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("WIFI_PW"));
     wifiMgrPortalAddConfigEntry("WiFi Password", "WIFI_PW", STRING, true, true);
     wifiMgrPortalAddConfigEntry("Hostname", "HOST", STRING, false, true);
     if (ssid != nullptr && pw != nullptr) {
         // configured
-        const char* host = wifiMgrGetConfig("HOST");
+        wifiMgrSetFastReconnect(true, true);
+        wifiMgrLoadNetworksFromConfig();
+        wifiMgrPortalApplyIPConfig();
+        const char* host = wifiMgrGetConfig(WIFI_MGR_CONFIG_KEY("HOST"));
         if (host == nullptr || strlen(host) == 0) {
             String macAddress = WiFi.macAddress();
             macAddress.replace(":", "");
@@ -538,20 +573,54 @@ void wifiMgrPortalSetup(bool redirectIndex, const char* ssidPrefix_, const char*
     if (wifiMgrPortalWebServer == nullptr) {
         wifiMgrPortalWebServer = new XWebServer(80);
         wifiMgrPortalIsOwnServer = true;
+        // needed for the 304 responses of the assets. A shared server has to collect If-None-Match itself
+        static const char* collectHeaders[] = {"If-None-Match"};
+        wifiMgrPortalWebServer->collectHeaders(collectHeaders, 1);
     }
     
     // Add routes for CSS and JS files
-    wifiMgrPortalWebServer->on("/wifiMgr/style.css", HTTP_GET, handleCSS);
-    wifiMgrPortalWebServer->on("/wifiMgr/script.js", HTTP_GET, handleJS);
+    wifiMgrPortalWebServer->on("/wifiMgr/style.css", HTTP_GET, wifiMgrTimed(handleCSS));
+    wifiMgrPortalWebServer->on("/wifiMgr/script.js", HTTP_GET, wifiMgrTimed(handleJS));
     
     // Add routes for configuration
-    wifiMgrPortalWebServer->on("/wifiMgr/configure", HTTP_POST, wifiMgrPortalSendConfigure);
-    wifiMgrPortalWebServer->on("/wifiMgr/configure", HTTP_GET, wifiMgrPortalSendConfigure);
+    wifiMgrPortalWebServer->on("/wifiMgr/configure", HTTP_POST, wifiMgrTimed(wifiMgrPortalSendConfigure));
+    wifiMgrPortalWebServer->on("/wifiMgr/configure", HTTP_GET, wifiMgrTimed(wifiMgrPortalSendConfigure));
+    wifiMgrPortalWebServer->on("/wifiMgr/api/config", HTTP_GET, wifiMgrTimed(wifiMgrPortalApiGetConfig));
+    wifiMgrPortalWebServer->on("/wifiMgr/api/config", HTTP_POST, wifiMgrTimed(wifiMgrPortalApiSetConfig));
+    wifiMgrPortalWebServer->on("/wifiMgr/api/config", HTTP_PATCH, wifiMgrTimed(wifiMgrPortalApiSetConfig));
+    wifiMgrPortalWebServer->on("/wifiMgr/api/apply-status", HTTP_GET, wifiMgrTimed(wifiMgrPortalApiApplyStatus));
+    wifiMgrPortalWebServer->on("/wifiMgr/api/networks", HTTP_GET, wifiMgrTimed(wifiMgrPortalApiNetworks));
     if (wifiMgrPortalRedirectIndex) {
-        // TODO: actually do a redirect
-        wifiMgrPortalWebServer->on("/", HTTP_POST, wifiMgrPortalSendConfigure);
-        wifiMgrPortalWebServer->on("/", HTTP_GET, wifiMgrPortalSendConfigure);
+        // POST stays for forms that were loaded from / before
+        wifiMgrPortalWebServer->on("/", HTTP_POST, wifiMgrTimed(wifiMgrPortalSendConfigure));
+        wifiMgrPortalWebServer->on("/", HTTP_GET, handleIndex);
     }
+    const char* captiveChecks[] = {
+        "/generate_204", "/gen_204", // Android, ChromeOS
+        "/hotspot-detect.html", "/library/test/success.html", // Apple
+        "/connecttest.txt", "/ncsi.txt", "/redirect", // Windows
+        "/canonical.html", "/success.txt" // Firefox
+    };
+    for (const char* path : captiveChecks) {
+        wifiMgrPortalWebServer->on(path, HTTP_GET, handleCaptiveCheck);
+    }
+}
+
+void wifiMgrPortalIndexEntry(PortalConfigEntry* entry) {
+    uint16_t i = entry->keyHash & (entryIndexSize - 1);
+    while (entryIndex[i] != nullptr) i = (i + 1) & (entryIndexSize - 1);
+    entryIndex[i] = entry;
+}
+
+bool wifiMgrPortalGrowIndex() {
+    uint16_t size = entryIndexSize == 0 ? 16 : entryIndexSize * 2;
+    auto **index = new (std::nothrow) PortalConfigEntry*[size]();
+    if (index == nullptr) return false;
+    delete[] entryIndex;
+    entryIndex = index;
+    entryIndexSize = size;
+    for (PortalConfigEntry* tmp = firstEntry; tmp != nullptr; tmp = tmp->next) wifiMgrPortalIndexEntry(tmp);
+    return true;
 }
 
 void wifiMgrPortalAddConfigEntry(const char* name, const char* eepromKey, PortalConfigEntryType type, bool isPassword, bool restartOnChange) {
@@ -565,6 +634,15 @@ void wifiMgrPortalAddConfigEntry(const char* name, const char* eepromKey, Portal
     newEntry->type = type;
     newEntry->isPassword = isPassword;
     newEntry->restartOnChange = restartOnChange;
+    newEntry->keyHash = wifiMgrConfigHash(eepromKey);
+    newEntry->argIndex = -1;
+
+    if ((entryCount + 1) * 2 > entryIndexSize && !wifiMgrPortalGrowIndex()) {
+        delete newEntry;
+        return;
+    }
+    wifiMgrPortalIndexEntry(newEntry);
+    entryCount++;
 
     PortalConfigEntry* last = getLastEntry();
     if (last == nullptr) firstEntry = newEntry;
@@ -579,9 +657,29 @@ void wifiMgrPortalUseExtraConfigs() {
     wifiMgrPortalAddConfigEntry("Rescan Interval (ms)", "WM_TO_RES", NUMBER, false, false);
 }
 
+void wifiMgrPortalUseExtraNetworks() {
+    wifiMgrPortalAddConfigEntry("SSID 2", "SSID_2", STRING, false, false);
+    wifiMgrPortalAddConfigEntry("WiFi Password 2", "WIFI_PW_2", STRING, true, false);
+    wifiMgrPortalAddConfigEntry("SSID 3", "SSID_3", STRING, false, false);
+    wifiMgrPortalAddConfigEntry("WiFi Password 3", "WIFI_PW_3", STRING, true, false);
+    wifiMgrPortalAddConfigEntry("SSID 4", "SSID_4", STRING, false, false);
+    wifiMgrPortalAddConfigEntry("WiFi Password 4", "WIFI_PW_4", STRING, true, false);
+}
+
+void wifiMgrPortalUseStaticIPConfigs() {
+    wifiMgrPortalAddConfigEntry("Static IP (empty for DHCP)", "WM_IP", STRING, false, true);
+    wifiMgrPortalAddConfigEntry("Gateway", "WM_GW", STRING, false, true);
+    wifiMgrPortalAddConfigEntry("Netmask", "WM_MASK", STRING, false, true);
+    wifiMgrPortalAddConfigEntry("DNS", "WM_DNS", STRING, false, true);
+    wifiMgrPortalAddConfigEntry("Reuse last DHCP lease", "WM_LEASE", BOOL, false, true);
+}
+
 bool wifiMgrPortalLoop() {
+    wifiMgrPortalApplyLoop();
     if (wifiMgrPortalIsSetup) {
         loopWifi();
+        // the AP stays up for a grace period after a successful apply, so do the captive portal answers
+        if (wifiMgrPortalApplyKeepsAP) wifiMgrDnsLoop();
         if (wifiMgrPortalWebServer != nullptr) wifiMgrPortalWebServer->handleClient();
         return true;
     } else if (!wifiMgrPortalStarted) {
@@ -589,6 +687,7 @@ bool wifiMgrPortalLoop() {
         macAddress.replace(":", "");
         macAddress = macAddress.substring(6, macAddress.length());
         WiFi.softAP((String(ssidPrefix != nullptr ? ssidPrefix : "") + macAddress).c_str(), password);
+        wifiMgrDnsStart(WiFi.softAPIP());
 
 #if defined(ESP8266)
         if (wifiMgrPortalWebServer != nullptr && wifiMgrPortalWebServer->getServer().status() == 0) wifiMgrPortalWebServer->begin();
@@ -596,6 +695,9 @@ bool wifiMgrPortalLoop() {
 
         wifiMgrPortalStarted = true;
     } else {
+        wifiMgrDnsLoop();
+        // the station is busy while credentials are being applied
+        if (!wifiMgrPortalIsApplying()) wifiMgrScanCacheLoop();
         if (wifiMgrPortalWebServer != nullptr) wifiMgrPortalWebServer->handleClient();
     }
     return false;
@@ -635,8 +737,13 @@ void wifiMgrPortalCleanup() {
     }
     
     firstEntry = nullptr;
+    delete[] entryIndex;
+    entryIndex = nullptr;
+    entryIndexSize = 0;
+    entryCount = 0;
 
     onChangeListeners.clear();
+    wifiMgrDnsStop();
     
     // If we created our own server, delete it
     if (wifiMgrPortalIsOwnServer && wifiMgrPortalWebServer != nullptr) {
@@ -0,0 +1,151 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#include "wifi_mgr_scan_cache.h"
+#include "wifi_mgr_json.h"
+
+struct WifiMgrScanCacheEntry {
+    char ssid[33];
+    int8_t rssi;
+    uint8_t channel;
+    uint8_t encryption; // as reported by the core
+    unsigned long lastSeen;
+};
+
+WifiMgrScanCacheEntry wifiMgrScanCache[WIFI_MGR_SCAN_CACHE_SIZE];
+uint8_t wifiMgrScanCacheCount = 0;
+bool wifiMgrScanCacheScanning = false;
+unsigned long wifiMgrScanCacheScanStart = 0;
+unsigned long wifiMgrScanCacheLastScan = 0;
+bool wifiMgrScanCacheHasScanned = false;
+
+bool wifiMgrScanCacheIsOpen(uint8_t encryption) {
+#if defined(ESP8266)
+    return encryption == ENC_TYPE_NONE;
+#elif defined(ESP32)
+    return encryption == WIFI_AUTH_OPEN;
+#endif
+}
+
+const char* wifiMgrScanCacheAuthName(uint8_t encryption) {
+#if defined(ESP8266)
+    switch (encryption) {
+        case ENC_TYPE_NONE: return "open";
+        case ENC_TYPE_WEP: return "wep";
+        case ENC_TYPE_TKIP: return "wpa";
+        case ENC_TYPE_CCMP: return "wpa2";
+        case ENC_TYPE_AUTO: return "wpa/wpa2";
+        default: return "other";
+    }
+#elif defined(ESP32)
+    switch (encryption) {
+        case WIFI_AUTH_OPEN: return "open";
+        case WIFI_AUTH_WEP: return "wep";
+        case WIFI_AUTH_WPA_PSK: return "wpa";
+        case WIFI_AUTH_WPA2_PSK: return "wpa2";
+        case WIFI_AUTH_WPA_WPA2_PSK: return "wpa/wpa2";
+        case WIFI_AUTH_WPA2_ENTERPRISE: return "wpa2-enterprise";
+        default: return "other";
+    }
+#endif
+}
+
+void wifiMgrScanCacheAdd(const String& ssid, int8_t rssi, uint8_t channel, uint8_t encryption) {
+    if (ssid.length() == 0 || ssid.length() >= sizeof(wifiMgrScanCache[0].ssid)) return;
+    WifiMgrScanCacheEntry* entry = nullptr;
+    for (uint8_t i = 0; i < wifiMgrScanCacheCount; i++) {
+        if (strcmp(wifiMgrScanCache[i].ssid, ssid.c_str()) == 0) {
+            entry = &wifiMgrScanCache[i];
+            break;
+        }
+    }
+    if (entry != nullptr) {
+        // another BSSID of the same SSID in this scan only counts if it is stronger
+        if (entry->lastSeen == wifiMgrScanCacheLastScan && entry->rssi >= rssi) return;
+    } else if (wifiMgrScanCacheCount < WIFI_MGR_SCAN_CACHE_SIZE) {
+        entry = &wifiMgrScanCache[wifiMgrScanCacheCount++];
+    } else {
+        // full, replace the weakest if the new one is stronger
+        entry = &wifiMgrScanCache[0];
+        for (uint8_t i = 1; i < WIFI_MGR_SCAN_CACHE_SIZE; i++) {
+            if (wifiMgrScanCache[i].rssi < entry->rssi) entry = &wifiMgrScanCache[i];
+        }
+        if (entry->rssi >= rssi) return;
+    }
+    strcpy(entry->ssid, ssid.c_str());
+    entry->rssi = rssi;
+    entry->channel = channel;
+    entry->encryption = encryption;
+    entry->lastSeen = wifiMgrScanCacheLastScan;
+}
+
+void wifiMgrScanCacheExpire() {
+    uint8_t i = 0;
+    while (i < wifiMgrScanCacheCount) {
+        if (millis() - wifiMgrScanCache[i].lastSeen > WIFI_MGR_SCAN_CACHE_MAX_AGE) {
+            wifiMgrScanCache[i] = wifiMgrScanCache[--wifiMgrScanCacheCount];
+        } else {
+            i++;
+        }
+    }
+}
+
+void wifiMgrScanCacheLoop() {
+    if (!wifiMgrScanCacheScanning) {
+        if (wifiMgrScanCacheHasScanned && millis() - wifiMgrScanCacheLastScan < WIFI_MGR_SCAN_CACHE_INTERVAL) return;
+        if (WiFi.scanNetworks(true, false) == WIFI_SCAN_FAILED) {
+            // try again next interval
+            wifiMgrScanCacheLastScan = millis();
+            wifiMgrScanCacheHasScanned = true;
+            return;
+        }
+        wifiMgrScanCacheScanning = true;
+        wifiMgrScanCacheScanStart = millis();
+        return;
+    }
+
+    int16_t found = WiFi.scanComplete();
+    if (found == WIFI_SCAN_RUNNING) {
+        if (millis() - wifiMgrScanCacheScanStart < 10000) return;
+        found = WIFI_SCAN_FAILED;
+    }
+    wifiMgrScanCacheScanning = false;
+    wifiMgrScanCacheHasScanned = true;
+    wifiMgrScanCacheLastScan = millis();
+    for (int16_t i = 0; i < found; i++) {
+        wifiMgrScanCacheAdd(WiFi.SSID(i), WiFi.RSSI(i), WiFi.channel(i), WiFi.encryptionType(i));
+    }
+    WiFi.scanDelete();
+    wifiMgrScanCacheExpire();
+}
+
+void wifiMgrScanCacheStop() {
+    wifiMgrScanCacheScanning = false;
+}
+
+void wifiMgrScanCacheWriteJson(WifiMgrChunkWriter* writer) {
+    wifiMgrChunkPrintf(writer, "{\"age\":%ld,\"scanning\":%s,\"networks\":[", wifiMgrScanCacheHasScanned ? (long) (millis() - wifiMgrScanCacheLastScan) : -1L,
+                       wifiMgrScanCacheScanning ? "true" : "false");
+    // strongest first without sorting the table: pick the next weaker entry on every round
+    int16_t previousRssi = 1;
+    int8_t previousIndex = -1;
+    for (uint8_t written = 0; written < wifiMgrScanCacheCount; written++) {
+        int8_t next = -1;
+        for (uint8_t i = 0; i < wifiMgrScanCacheCount; i++) {
+            const WifiMgrScanCacheEntry* entry = &wifiMgrScanCache[i];
+            // (rssi, index) descending, so equal RSSIs are not skipped
+            bool after = entry->rssi < previousRssi || (entry->rssi == previousRssi && i > previousIndex);
+            if (!after) continue;
+            if (next < 0 || entry->rssi > wifiMgrScanCache[next].rssi) next = i;
+        }
+        if (next < 0) break;
+        const WifiMgrScanCacheEntry* entry = &wifiMgrScanCache[next];
+        wifiMgrChunkWrite(writer, written == 0 ? "{\"ssid\":" : ",{\"ssid\":");
+        wifiMgrJsonWriteString(writer, entry->ssid);
+        wifiMgrChunkPrintf(writer, ",\"rssi\":%d,\"channel\":%u,\"auth\":\"%s\",\"open\":%s,\"age\":%lu}", entry->rssi, entry->channel,
+                           wifiMgrScanCacheAuthName(entry->encryption), wifiMgrScanCacheIsOpen(entry->encryption) ? "true" : "false",
+                           millis() - entry->lastSeen);
+        previousRssi = entry->rssi;
+        previousIndex = next;
+    }
+    wifiMgrChunkWrite(writer, "]}");
+}
@@ -0,0 +1,169 @@
+// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+
+#include "wifi_mgr_stats.h"
+
+// histogram buckets are 5dB wide, everything below / above the range ends up in the first / last bucket
+#define WIFI_MGR_RSSI_HISTOGRAM_MIN -95
+#define WIFI_MGR_RSSI_HISTOGRAM_MAX -40
+#define WIFI_MGR_RSSI_HISTOGRAM_STEP 5
+
+int8_t rssiSamples[WIFI_MGR_RSSI_SAMPLES];
+uint16_t rssiSampleHead = 0;
+uint16_t rssiSampleCount = 0;
+// exponentially weighted moving average (alpha 1/8) in 1/16 dB
+int32_t rssiEwma = 0;
+bool rssiEwmaValid = false;
+
+// upper bounds of the finite buckets in us, the +Inf bucket is implicit
+#define WIFI_MGR_HISTOGRAM_BUCKETS 8
+
+struct WifiMgrHistogram {
+    const char* name;
+    uint32_t bounds[WIFI_MGR_HISTOGRAM_BUCKETS];
+    uint32_t counts[WIFI_MGR_HISTOGRAM_BUCKETS + 1];
+    uint32_t count;
+    uint64_t sumUs;
+};
+
+WifiMgrHistogram histograms[WIFI_MGR_HISTOGRAM_COUNT] = {
+    {"wifimgr_scan_duration_seconds", {100000, 250000, 500000, 1000000, 2000000, 3000000, 5000000, 10000000}, {}, 0, 0},
+    {"wifimgr_connect_duration_seconds", {250000, 500000, 1000000, 2000000, 5000000, 10000000, 20000000, 30000000}, {}, 0, 0},
+    {"wifimgr_http_handler_duration_seconds", {1000, 5000, 10000, 25000, 50000, 100000, 250000, 1000000}, {}, 0, 0}
+};
+
+WifiMgrConnectTrace traces[WIFI_MGR_TRACE_SIZE];
+uint8_t traceHead = 0;
+uint8_t traceCount = 0;
+const char* traceResultNames[] = {"running", "connected", "failed", "kept"};
+
+void wifiMgrStatsAddRssi(int8_t rssi) {
+    rssiSamples[rssiSampleHead] = rssi;
+    rssiSampleHead = (rssiSampleHead + 1) % WIFI_MGR_RSSI_SAMPLES;
+    if (rssiSampleCount < WIFI_MGR_RSSI_SAMPLES) rssiSampleCount++;
+
+    if (!rssiEwmaValid) {
+        rssiEwma = rssi * 16;
+        rssiEwmaValid = true;
+    } else {
+        rssiEwma += (rssi * 16 - rssiEwma) / 8;
+    }
+}
+
+void wifiMgrStatsResetSmoothing() {
+    rssiEwmaValid = false;
+}
+
+int8_t wifiMgrStatsSmoothedRssi() {
+    if (!rssiEwmaValid) return 0;
+    return (int8_t) ((rssiEwma - 8) / 16);
+}
+
+size_t wifiMgrStatsFormatLinkQuality(char* buffer, size_t size) {
+    int len = 0;
+    len += snprintf(buffer + len, size - len, "samples: %u\n", rssiSampleCount);
+    if (rssiSampleCount == 0) return len;
+
+    // sorted copy for the percentiles, small enough to live on the stack
+    int8_t sorted[WIFI_MGR_RSSI_SAMPLES];
+    int32_t sum = 0;
+    for (uint16_t i = 0; i < rssiSampleCount; i++) {
+        int8_t sample = rssiSamples[i];
+        sum += sample;
+        uint16_t j = i;
+        while (j > 0 && sorted[j - 1] > sample) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = sample;
+    }
+
+    len += snprintf(buffer + len, size - len, "ewma: %d\n", wifiMgrStatsSmoothedRssi());
+    len += snprintf(buffer + len, size - len, "min: %d\n", sorted[0]);
+    len += snprintf(buffer + len, size - len, "avg: %ld\n", (long) (sum / rssiSampleCount));
+    len += snprintf(buffer + len, size - len, "max: %d\n", sorted[rssiSampleCount - 1]);
+    len += snprintf(buffer + len, size - len, "p10: %d\n", sorted[rssiSampleCount * 10 / 100]);
+    len += snprintf(buffer + len, size - len, "p50: %d\n", sorted[rssiSampleCount * 50 / 100]);
+    len += snprintf(buffer + len, size - len, "p90: %d\n\n", sorted[rssiSampleCount * 90 / 100]);
+
+    uint16_t i = 0;
+    for (int bucket = WIFI_MGR_RSSI_HISTOGRAM_MIN; bucket <= WIFI_MGR_RSSI_HISTOGRAM_MAX; bucket += WIFI_MGR_RSSI_HISTOGRAM_STEP) {
+        uint16_t count = 0;
+        while (i < rssiSampleCount && (bucket == WIFI_MGR_RSSI_HISTOGRAM_MAX || sorted[i] < bucket + WIFI_MGR_RSSI_HISTOGRAM_STEP)) {
+            count++;
+            i++;
+        }
+        if (bucket == WIFI_MGR_RSSI_HISTOGRAM_MIN) {
+            len += snprintf(buffer + len, size - len, "< %d: %u\n", bucket + WIFI_MGR_RSSI_HISTOGRAM_STEP, count);
+        } else if (bucket == WIFI_MGR_RSSI_HISTOGRAM_MAX) {
+            len += snprintf(buffer + len, size - len, ">= %d: %u\n", bucket, count);
+        } else {
+            len += snprintf(buffer + len, size - len, "%d..%d: %u\n", bucket, bucket + WIFI_MGR_RSSI_HISTOGRAM_STEP - 1, count);
+        }
+        if ((size_t) len >= size) return size - 1;
+    }
+    return len;
+}
+
+WifiMgrConnectTrace* wifiMgrTraceStart(uint8_t flags) {
+    WifiMgrConnectTrace* trace = &traces[traceHead];
+    traceHead = (traceHead + 1) % WIFI_MGR_TRACE_SIZE;
+    if (traceCount < WIFI_MGR_TRACE_SIZE) traceCount++;
+    memset(trace, 0, sizeof(WifiMgrConnectTrace));
+    trace->start = millis();
+    trace->flags = flags;
+    return trace;
+}
+
+size_t wifiMgrTraceFormat(uint8_t index, char* buffer, size_t size) {
+    if (index >= traceCount) return 0;
+    const WifiMgrConnectTrace* trace = &traces[(traceHead + WIFI_MGR_TRACE_SIZE - 1 - index) % WIFI_MGR_TRACE_SIZE];
+    int len = snprintf(buffer, size, "start=%lums result=%s fast=%d roam=%d disconnect=%u scan=%u networks=%u bssid=%02x:%02x:%02x:%02x:%02x:%02x channel=%u associate=%u dhcp=%u mdns=%u server=%u\n",
+                       trace->start, traceResultNames[trace->result], (trace->flags & WIFI_MGR_TRACE_FAST) != 0, (trace->flags & WIFI_MGR_TRACE_ROAM) != 0,
+                       trace->disconnectMs, trace->scanMs, trace->networks,
+                       trace->bssid[0], trace->bssid[1], trace->bssid[2], trace->bssid[3], trace->bssid[4], trace->bssid[5], trace->channel,
+                       trace->associateMs, trace->dhcpMs, trace->mdnsMs, trace->serverMs);
+    if (len < 0) return 0;
+    return (size_t) len >= size ? size - 1 : len;
+}
+
+void wifiMgrStatsObserve(WifiMgrHistogramId histogram, uint32_t durationUs) {
+    WifiMgrHistogram* h = &histograms[histogram];
+    uint8_t bucket = 0;
+    while (bucket < WIFI_MGR_HISTOGRAM_BUCKETS && durationUs > h->bounds[bucket]) bucket++;
+    h->counts[bucket]++;
+    h->count++;
+    h->sumUs += durationUs;
+}
+
+// seconds in the canonical OpenMetrics form: no trailing zeros but at least one decimal
+void wifiMgrStatsFormatSeconds(uint64_t us, char* buffer, size_t size) {
+    int len = snprintf(buffer, size, "%lu.%06lu", (unsigned long) (us / 1000000), (unsigned long) (us % 1000000));
+    if (len < 0 || (size_t) len >= size) return;
+    while (len > 0 && buffer[len - 1] == '0' && buffer[len - 2] != '.') buffer[--len] = 0;
+}
+
+size_t wifiMgrStatsFormatHistogram(WifiMgrHistogramId histogram, uint8_t line, char* buffer, size_t size) {
+    const WifiMgrHistogram* h = &histograms[histogram];
+    char seconds[24];
+    int len;
+    if (line == 0) {
+        len = snprintf(buffer, size, "# TYPE %s histogram\n# UNIT %s seconds\n", h->name, h->name);
+    } else if (line <= WIFI_MGR_HISTOGRAM_BUCKETS + 1) {
+        // buckets are cumulative in the exposition format
+        uint32_t cumulative = 0;
+        for (uint8_t i = 0; i < line; i++) cumulative += h->counts[i];
+        if (line <= WIFI_MGR_HISTOGRAM_BUCKETS) {
+            wifiMgrStatsFormatSeconds(h->bounds[line - 1], seconds, sizeof(seconds));
+        } else {
+            strcpy(seconds, "+Inf");
+        }
+        len = snprintf(buffer, size, "%s_bucket{le=\"%s\"} %lu\n", h->name, seconds, (unsigned long) cumulative);
+    } else if (line == WIFI_MGR_HISTOGRAM_BUCKETS + 2) {
+        wifiMgrStatsFormatSeconds(h->sumUs, seconds, sizeof(seconds));
+        len = snprintf(buffer, size, "%s_sum %s\n%s_count %lu\n", h->name, seconds, h->name, (unsigned long) h->count);
+    } else {
+        return 0;
+    }
+    if (len < 0) return 0;
+    return (size_t) len >= size ? size - 1 : len;
+}
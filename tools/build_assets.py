@@ -0,0 +1,91 @@
+# PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/
+#
+# Minifies and gzips the portal assets in web/ into src/wifi_mgr_assets.h (PROGMEM byte arrays).
+# Runs as PlatformIO extra script before every build (see library.json) and can be run by hand:
+#   python3 tools/build_assets.py
+# The header is only rewritten if its content changes, the generated file is checked in
+# so the library also builds without python.
+
+import gzip
+import hashlib
+import inspect
+import os
+import re
+
+ASSETS = [
+    # (source, symbol, minifier, etag define)
+    ("style.css", "wifiMgrAssetStyleCss", "css", "WIFI_MGR_ASSET_STYLE_CSS_ETAG"),
+    ("script.js", "wifiMgrAssetScriptJs", "js", "WIFI_MGR_ASSET_SCRIPT_JS_ETAG"),
+]
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{};:,>])\s*", r"\1", text)
+    return text.replace(";}", "}").strip()
+
+
+def minify_js(text):
+    # conservative: drop comment lines, indentation and blank lines but keep line breaks (ASI)
+    lines = []
+    for line in text.splitlines():
+        line = line.strip()
+        if line == "" or line.startswith("//"):
+            continue
+        lines.append(line)
+    return "\n".join(lines)
+
+
+def c_array(data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]))
+    return ",\n".join(rows)
+
+
+def generate(root):
+    out = [
+        "// PUBLISHED UNDER CC BY-NC 4.0 https://creativecommons.org/licenses/by-nc/4.0/",
+        "// generated by tools/build_assets.py from web/, do not edit",
+        "",
+        "#ifndef WIFI_MGR_ASSETS_H",
+        "#define WIFI_MGR_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+    ]
+    for source, symbol, kind, etag in ASSETS:
+        with open(os.path.join(root, "web", source), encoding="utf-8") as f:
+            text = f.read()
+        minified = (minify_css if kind == "css" else minify_js)(text).encode("utf-8")
+        # mtime 0 keeps the output reproducible
+        data = gzip.compress(minified, compresslevel=9, mtime=0)
+        out.append("// web/%s: %d bytes, %d minified, %d gzipped" % (source, len(text.encode("utf-8")), len(minified), len(data)))
+        # content hash, used as ETag and as version in the asset urls
+        out.append("#define %s \"%s\"" % (etag, hashlib.sha1(data).hexdigest()[:16]))
+        out.append("const uint8_t %s[] PROGMEM = {" % symbol)
+        out.append(c_array(data))
+        out.append("};")
+        out.append("")
+    out.append("#endif //WIFI_MGR_ASSETS_H")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    # __file__ is not set when PlatformIO runs this as SCons script
+    root = os.path.dirname(os.path.dirname(os.path.abspath(inspect.getframeinfo(inspect.currentframe()).filename)))
+    target = os.path.join(root, "src", "wifi_mgr_assets.h")
+    content = generate(root)
+    current = None
+    if os.path.exists(target):
+        with open(target, encoding="utf-8") as f:
+            current = f.read()
+    if content != current:
+        with open(target, "w", encoding="utf-8") as f:
+            f.write(content)
+        print("build_assets: updated " + target)
+
+
+main()
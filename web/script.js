@@ -0,0 +1,211 @@
+// WiFi Manager Portal JavaScript
+document.addEventListener('DOMContentLoaded', function() {
+  // Add form submission handling
+  const form = document.querySelector('form');
+  if (form) {
+    form.addEventListener('submit', function(e) {
+      // Show loading message
+      const submitBtn = form.querySelector('input[type="submit"]');
+      if (submitBtn) {
+        const originalText = submitBtn.value || 'Submit';
+        submitBtn.value = 'Saving...';
+        submitBtn.disabled = true;
+        
+        // Re-enable after submission (for cases where page doesn't reload)
+        setTimeout(() => {
+          submitBtn.value = originalText;
+          submitBtn.disabled = false;
+        }, 5000);
+      }
+    });
+  }
+
+  // Add password visibility toggle
+  const passwordInputs = document.querySelectorAll('input[type="password"]');
+  passwordInputs.forEach(input => {
+    // Create toggle button
+    const toggleBtn = document.createElement('button');
+    toggleBtn.type = 'button';
+    toggleBtn.className = 'password-toggle';
+    toggleBtn.textContent = 'Show';
+    toggleBtn.style.position = 'absolute';
+    toggleBtn.style.right = '10px';
+    toggleBtn.style.top = '50%';
+    toggleBtn.style.transform = 'translateY(-50%)';
+    toggleBtn.style.background = 'none';
+    toggleBtn.style.border = 'none';
+    toggleBtn.style.color = '#2196F3';
+    toggleBtn.style.cursor = 'pointer';
+    toggleBtn.style.fontSize = '14px';
+    
+    // Create wrapper for positioning
+    const wrapper = document.createElement('div');
+    wrapper.style.position = 'relative';
+    
+    // Insert wrapper and move input inside
+    input.parentNode.insertBefore(wrapper, input);
+    wrapper.appendChild(input);
+    wrapper.appendChild(toggleBtn);
+    
+    // Add toggle functionality
+    toggleBtn.addEventListener('click', function() {
+      if (input.type === 'password') {
+        input.type = 'text';
+        toggleBtn.textContent = 'Hide';
+      } else {
+        input.type = 'password';
+        toggleBtn.textContent = 'Show';
+      }
+    });
+  });
+
+  // Add validation for form fields
+  const inputs = document.querySelectorAll('input[type="text"], input[type="password"], input[type="number"]');
+  inputs.forEach(input => {
+    input.addEventListener('blur', function() {
+      validateInput(input);
+    });
+  });
+
+  // Offer the networks around as suggestions for the SSID fields
+  const networkList = document.getElementById('wifiMgrNetworks');
+  if (networkList) {
+    loadNetworks(networkList);
+  }
+
+  // Follow WiFi changes that are applied in the background
+  const applyStatus = document.getElementById('apply-status');
+  if (applyStatus) {
+    pollApplyStatus(applyStatus);
+  }
+
+  // Add message auto-hide
+  const messages = document.querySelectorAll('.message:not(#apply-status)');
+  if (messages.length > 0) {
+    setTimeout(() => {
+      messages.forEach(msg => {
+        msg.style.opacity = '0';
+        msg.style.transition = 'opacity 0.5s ease';
+        setTimeout(() => {
+          msg.style.display = 'none';
+        }, 500);
+      });
+    }, 5000);
+  }
+});
+
+// Fill the SSID suggestions from the scan cache, again while the first scan is still running
+function loadNetworks(list) {
+  fetch('/wifiMgr/api/networks')
+    .then(response => response.json())
+    .then(result => {
+      list.innerHTML = '';
+      result.networks.forEach(network => {
+        const option = document.createElement('option');
+        option.value = network.ssid;
+        option.label = network.rssi + ' dBm' + (network.open ? ', open' : '');
+        list.appendChild(option);
+      });
+      if (result.age < 0 || result.scanning) {
+        setTimeout(() => loadNetworks(list), 3000);
+      }
+    })
+    .catch(() => {});
+}
+
+// Poll the state of the background apply until it is finished
+function pollApplyStatus(element) {
+  fetch('/wifiMgr/api/apply-status')
+    .then(response => response.json())
+    .then(status => {
+      if (status.state === 'pending' || status.state === 'connecting' || status.state === 'committing') {
+        element.textContent = 'Applying WiFi settings... (' + status.phase + ')';
+        setTimeout(() => pollApplyStatus(element), 1000);
+      } else if (status.state === 'failed') {
+        element.className = 'message error';
+        element.textContent = 'Failed to connect to WiFi. Please check your credentials.';
+      } else {
+        element.className = 'message success';
+        element.textContent = 'Connected to ' + status.ssid + ' with IP ' + status.ip + (status.restart ? ', the device restarts now.' : '.');
+        if (status.commitFailed) {
+          element.textContent += ' Failed to save settings to EEPROM.';
+        }
+      }
+    })
+    .catch(() => {
+      // the portal AP may be briefly unavailable while the radio switches channel
+      setTimeout(() => pollApplyStatus(element), 2000);
+    });
+}
+
+// Input validation function
+function validateInput(input) {
+  // Clear previous validation
+  const existingError = input.parentNode.querySelector('.validation-error');
+  if (existingError) {
+    existingError.remove();
+  }
+  
+  // Skip validation for empty optional fields
+  if (!input.value && !input.hasAttribute('required')) {
+    return true;
+  }
+  
+  let isValid = true;
+  let errorMessage = '';
+  
+  // Validate based on input type or name
+  if (input.name === 'SSID' && input.value.length < 1) {
+    isValid = false;
+    errorMessage = 'SSID is required';
+  } else if (input.name === 'HOST' && input.value.length > 0) {
+    // Hostname validation (letters, numbers, hyphens, no spaces)
+    const hostnameRegex = /^[a-zA-Z0-9-]+$/;
+    if (!hostnameRegex.test(input.value)) {
+      isValid = false;
+      errorMessage = 'Hostname can only contain letters, numbers, and hyphens';
+    }
+  } else if (input.type === 'number') {
+    const min = input.getAttribute('min');
+    const max = input.getAttribute('max');
+    
+    if (min !== null && parseInt(input.value) < parseInt(min)) {
+      isValid = false;
+      errorMessage = `Value must be at least ${min}`;
+    } else if (max !== null && parseInt(input.value) > parseInt(max)) {
+      isValid = false;
+      errorMessage = `Value must be at most ${max}`;
+    }
+  }
+  
+  // Display error if validation failed
+  if (!isValid) {
+    const errorElement = document.createElement('div');
+    errorElement.className = 'validation-error';
+    errorElement.style.color = '#F44336';
+    errorElement.style.fontSize = '12px';
+    errorElement.style.marginTop = '5px';
+    errorElement.textContent = errorMessage;
+    
+    input.parentNode.appendChild(errorElement);
+    input.style.borderColor = '#F44336';
+  } else {
+    input.style.borderColor = '';
+  }
+  
+  return isValid;
+}
+
+// Form validation before submission
+function validateForm(form) {
+  const inputs = form.querySelectorAll('input[type="text"], input[type="password"], input[type="number"]');
+  let isValid = true;
+  
+  inputs.forEach(input => {
+    if (!validateInput(input)) {
+      isValid = false;
+    }
+  });
+  
+  return isValid;
+}